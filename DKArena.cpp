@@ -0,0 +1,95 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKArena.h"
+
+using namespace DKGeometry;
+
+
+DKGeometry::DFrameArena::DFrameArena(size_t blockSize, std::pmr::memory_resource * upstream)
+	: upstream(upstream), nextBlockSize((std::max)(blockSize, (size_t)256))
+{
+}
+
+DKGeometry::DFrameArena::~DFrameArena()
+{
+	release();
+}
+
+void DKGeometry::DFrameArena::reset()
+{
+	current = 0;
+	cursor = blocks.empty() ? nullptr : blocks[0].data;
+	limit = blocks.empty() ? nullptr : blocks[0].data + blocks[0].size;
+	allocated = 0;
+}
+
+void DKGeometry::DFrameArena::release()
+{
+	for (auto&eachBlock : blocks)
+	{
+		upstream->deallocate(eachBlock.data, eachBlock.size, alignof(std::max_align_t));
+	}
+	blocks.clear();
+	reserved = 0;
+	reset();
+}
+
+void * DKGeometry::DFrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+	for (;;)
+	{
+		if (cursor)
+		{
+			uintptr_t address = ((uintptr_t)cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+			if (address + bytes <= (uintptr_t)limit)
+			{
+				cursor = (char*)(address + bytes);
+				allocated += bytes;
+				return (void*)address;
+			}
+		}
+
+		// move on to the next kept block, or grow geometrically when there is none
+		if (cursor && current + 1 < blocks.size()) {
+			current++;
+		}
+		else {
+			size_t size = nextBlockSize;
+			while (size < bytes + alignment) size *= 2;
+			nextBlockSize = size * 2;
+
+			Block block = { (char*)upstream->allocate(size, alignof(std::max_align_t)), size };
+			reserved += size;
+			blocks.push_back(block);
+			current = blocks.size() - 1;
+		}
+		cursor = blocks[current].data;
+		limit = cursor + blocks[current].size;
+	}
+}
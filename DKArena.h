@@ -0,0 +1,77 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKGeometry.h"
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Monotonic per-frame arena for the pmr:: containers. Allocation bumps a
+	/// pointer, deallocation is a no-op, and reset() rewinds to the first
+	/// block in O(1) while keeping every block for the next frame, so a steady
+	/// workload stops touching the upstream heap after warm-up.
+	/// Not thread safe; use one arena per thread or per request.</summary>
+	class DFrameArena : public std::pmr::memory_resource
+	{
+	public:
+		explicit DFrameArena(size_t blockSize = 64 * 1024,
+			std::pmr::memory_resource*upstream = std::pmr::get_default_resource());
+		~DFrameArena();
+
+		DFrameArena(const DFrameArena&) = delete;
+		DFrameArena& operator=(const DFrameArena&) = delete;
+
+		// everything allocated since the last reset becomes invalid
+		void reset();
+		// returns every block to the upstream resource
+		void release();
+
+		inline size_t bytesAllocated() const { return allocated; }
+		inline size_t capacity() const { return reserved; }
+
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void*, size_t, size_t) override {}
+		bool do_is_equal(const std::pmr::memory_resource&other) const noexcept override { return this == &other; }
+
+	private:
+		struct Block
+		{
+			char* data;
+			size_t size;
+		};
+
+		std::pmr::memory_resource* upstream;
+		std::vector<Block> blocks;
+		size_t current = 0;
+		char* cursor = nullptr;
+		char* limit = nullptr;
+		size_t nextBlockSize;
+		size_t allocated = 0;
+		size_t reserved = 0;
+	};
+
+}
@@ -0,0 +1,108 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKAsyncQuery.h"
+
+#ifdef DKGEOMETRY_COROUTINES
+
+using namespace DKGeometry;
+
+
+DRectChunks DKGeometry::SearchChunks(DRectIndexView index, DRect area, size_t chunkSize, const DCancellation * cancel)
+{
+	if (index.isEmpty() || !index.items || chunkSize == 0) co_return;
+
+	area.Normalize();
+	if (!DRectIndexView::touches(index.root().bounds, area)) co_return;
+
+	// the traversal of DRectIndexView::VisitLeaves, unrolled so it can yield
+	std::vector<IDRect> chunk;
+	chunk.reserve(chunkSize);
+	size_t stack[256];
+	size_t depth = 0;
+	stack[depth++] = index.nodeCount - 1;
+	while (depth)
+	{
+		if (cancel && cancel->isCancelled()) co_return;
+
+		size_t nodeIndex = stack[--depth];
+		const DRectIndexNode&node = index.nodes[nodeIndex];
+		if (nodeIndex >= index.leafCount)
+		{
+			for (uint32_t i = node.first + node.count; i-- > node.first; )
+			{
+				if (DRectIndexView::touches(index.nodes[i].bounds, area)) stack[depth++] = i;
+			}
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++)
+		{
+			if (!DRectIndexView::touches(index.items[i], area)) continue;
+			chunk.push_back(index.items[i]);
+			if (chunk.size() == chunkSize)
+			{
+				co_yield std::span<const IDRect>(chunk.data(), chunk.size());
+				chunk.clear();
+				if (cancel && cancel->isCancelled()) co_return;
+			}
+		}
+	}
+	if (!chunk.empty()) co_yield std::span<const IDRect>(chunk.data(), chunk.size());
+}
+
+DJoinChunks DKGeometry::SpatialJoinChunks(const IDRArray & left, const DRectIndex & right, size_t chunkSize, const DCancellation * cancel)
+{
+	if (chunkSize == 0) co_return;
+
+	DRectIndexView view = right.view();
+	std::vector<DJoinPair> chunk;
+	chunk.reserve(chunkSize);
+	std::vector<uint64_t> matches;
+	for (const auto&eachLeft : left)
+	{
+		if (cancel && cancel->isCancelled()) co_return;
+
+		// one left rect's matches are bounded by the right side, so collect them first
+		matches.clear();
+		view.Search(eachLeft, matches);
+		for (uint64_t eachMatch : matches)
+		{
+			chunk.push_back({ eachLeft.id, eachMatch });
+			if (chunk.size() == chunkSize)
+			{
+				co_yield std::span<const DJoinPair>(chunk.data(), chunk.size());
+				chunk.clear();
+				if (cancel && cancel->isCancelled()) co_return;
+			}
+		}
+	}
+	if (!chunk.empty()) co_yield std::span<const DJoinPair>(chunk.data(), chunk.size());
+}
+
+#endif // DKGEOMETRY_COROUTINES
@@ -0,0 +1,180 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKRectIndex.h"
+#include "DKSpatialJoin.h"
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && defined(__has_include)
+#if __has_include(<coroutine>) && __has_include(<span>)
+#define DKGEOMETRY_COROUTINES 1
+#endif
+#endif
+
+#ifdef DKGEOMETRY_COROUTINES
+#include <coroutine>
+#include <exception>
+#include <span>
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Cancellation flag shared between a caller and running queries.</summary>
+	class DCancellation
+	{
+	public:
+		inline void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+		inline void reset() { cancelled.store(false, std::memory_order_relaxed); }
+		inline bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+	private:
+		std::atomic<bool> cancelled{ false };
+	};
+
+	/// <summary>
+	/// Lazy, move-only pull generator. Values are produced one at a time as
+	/// the caller advances, either with a range for loop or with next().
+	/// A yielded value is only valid until the generator is advanced.</summary>
+	template <class T>
+	class DGenerator
+	{
+	public:
+		struct promise_type
+		{
+			const T* current = nullptr;
+
+			DGenerator get_return_object() { return DGenerator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+			std::suspend_always initial_suspend() noexcept { return {}; }
+			std::suspend_always final_suspend() noexcept { return {}; }
+			std::suspend_always yield_value(const T&value) noexcept {
+				current = std::addressof(value);
+				return {};
+			}
+			void return_void() {}
+			void unhandled_exception() { std::terminate(); }
+		};
+
+		class iterator
+		{
+		public:
+			inline iterator() {}
+			inline explicit iterator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+			inline const T& operator*() const { return *handle.promise().current; }
+			inline const T* operator->() const { return handle.promise().current; }
+			inline iterator& operator++() {
+				handle.resume();
+				return *this;
+			}
+			inline bool operator==(std::default_sentinel_t) const { return !handle || handle.done(); }
+			inline bool operator!=(std::default_sentinel_t end) const { return !(*this == end); }
+
+		private:
+			std::coroutine_handle<promise_type> handle;
+		};
+
+		inline DGenerator(DGenerator&&other) noexcept : handle(other.handle) { other.handle = nullptr; }
+		inline DGenerator& operator=(DGenerator&&other) noexcept {
+			if (this != &other) {
+				if (handle) handle.destroy();
+				handle = other.handle;
+				other.handle = nullptr;
+			}
+			return *this;
+		}
+		DGenerator(const DGenerator&) = delete;
+		DGenerator& operator=(const DGenerator&) = delete;
+		inline ~DGenerator() { if (handle) handle.destroy(); }
+
+		inline iterator begin() {
+			if (handle) handle.resume();
+			return iterator(handle);
+		}
+		inline std::default_sentinel_t end() { return std::default_sentinel; }
+
+		// advances to the next value; false once the generator has finished
+		inline bool next() {
+			if (!handle || handle.done()) return false;
+			handle.resume();
+			return !handle.done();
+		}
+		inline const T& value() const { return *handle.promise().current; }
+
+	private:
+		inline explicit DGenerator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+		std::coroutine_handle<promise_type> handle;
+	};
+
+	/// <summary>
+	/// Eagerly started, detached coroutine for async work; its frame frees
+	/// itself when the body finishes. Combine with ResumeOn to hop between
+	/// executors.</summary>
+	struct DTask
+	{
+		struct promise_type
+		{
+			DTask get_return_object() { return {}; }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_never final_suspend() noexcept { return {}; }
+			void return_void() {}
+			void unhandled_exception() { std::terminate(); }
+		};
+	};
+
+	struct DResumeOn
+	{
+		DExecutor&executor;
+
+		inline bool await_ready() const noexcept { return false; }
+		inline void await_suspend(std::coroutine_handle<> handle) const {
+			executor.post([handle]() { handle.resume(); });
+		}
+		inline void await_resume() const noexcept {}
+	};
+
+	// co_await ResumeOn(executor) continues the coroutine on one of executor's threads
+	inline DResumeOn ResumeOn(DExecutor&executor) { return DResumeOn{ executor }; }
+
+	typedef DGenerator<std::span<const IDRect>> DRectChunks;
+	typedef DGenerator<std::span<const DJoinPair>> DJoinChunks;
+
+	/// <summary>
+	/// Index search that yields matches in chunks of at most chunkSize as soon
+	/// as they are found, in the same order as DRectIndexView::Visit. Stops
+	/// early when cancel is set. The view's storage must outlive the generator.</summary>
+	DRectChunks SearchChunks(DRectIndexView index, DRect area, size_t chunkSize = 4096,
+		const DCancellation*cancel = nullptr);
+
+	/// <summary>
+	/// Incremental join: for each left rect in order, its overlapping rects in
+	/// right, yielded as pairs in chunks of at most chunkSize. Every pair comes
+	/// exactly once. Both containers must outlive the generator.</summary>
+	DJoinChunks SpatialJoinChunks(const IDRArray&left, const DRectIndex&right, size_t chunkSize = 4096,
+		const DCancellation*cancel = nullptr);
+
+}
+
+#endif // DKGEOMETRY_COROUTINES
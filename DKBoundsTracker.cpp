@@ -0,0 +1,166 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKBoundsTracker.h"
+
+using namespace DKGeometry;
+
+
+DKGeometry::DBoundsTracker::DBoundsTracker(const IDRArray & rects)
+{
+	assign(rects);
+}
+
+void DKGeometry::DBoundsTracker::assign(const IDRArray & rects)
+{
+	clear();
+	if (rects.empty()) return;
+	reserve(rects.size());
+
+	for (const auto&eachRect : rects)
+	{
+		auto inserted = slots.emplace(eachRect.id, (uint32_t)usedSlots);
+		if (inserted.second) usedSlots++;
+		tree[leafCount + inserted.first->second] = eachRect;
+	}
+	for (size_t node = leafCount - 1; node > 0; node--)
+	{
+		tree[node] = combined(tree[2 * node], tree[2 * node + 1]);
+	}
+}
+
+void DKGeometry::DBoundsTracker::clear()
+{
+	tree.clear();
+	leafCount = 0;
+	usedSlots = 0;
+	freeSlots.clear();
+	slots.clear();
+}
+
+void DKGeometry::DBoundsTracker::reserve(size_t count)
+{
+	if (count > leafCount) grow(count);
+	slots.reserve(count);
+}
+
+void DKGeometry::DBoundsTracker::grow(size_t capacity)
+{
+	size_t newLeafCount = 1;
+	while (newLeafCount < capacity) newLeafCount <<= 1;
+
+	std::vector<DRect> newTree(2 * newLeafCount, emptyRect());
+	for (size_t i = 0; i < usedSlots; i++)
+	{
+		newTree[newLeafCount + i] = tree[leafCount + i];
+	}
+	for (size_t node = newLeafCount - 1; node > 0; node--)
+	{
+		newTree[node] = combined(newTree[2 * node], newTree[2 * node + 1]);
+	}
+	tree.swap(newTree);
+	leafCount = newLeafCount;
+}
+
+void DKGeometry::DBoundsTracker::update(size_t slot, const DRect & rect)
+{
+	size_t node = leafCount + slot;
+	tree[node] = rect;
+	for (node >>= 1; node > 0; node >>= 1)
+	{
+		DRect parent = combined(tree[2 * node], tree[2 * node + 1]);
+		// ancestors only depend on this node, so an unchanged node ends the walk
+		if (parent == tree[node]) break;
+		tree[node] = parent;
+	}
+}
+
+bool DKGeometry::DBoundsTracker::insert(const IDRect & rect)
+{
+	if (slots.count(rect.id)) return false;
+
+	uint32_t slot;
+	if (!freeSlots.empty())
+	{
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else
+	{
+		if (usedSlots == leafCount) grow((std::max)((size_t)16, leafCount * 2));
+		slot = (uint32_t)usedSlots++;
+	}
+	slots.emplace(rect.id, slot);
+	update(slot, rect);
+	return true;
+}
+
+bool DKGeometry::DBoundsTracker::remove(uint64_t id)
+{
+	auto found = slots.find(id);
+	if (found == slots.end()) return false;
+
+	update(found->second, emptyRect());
+	freeSlots.push_back(found->second);
+	slots.erase(found);
+	return true;
+}
+
+bool DKGeometry::DBoundsTracker::move(uint64_t id, const DRect & rect)
+{
+	auto found = slots.find(id);
+	if (found == slots.end()) return false;
+
+	update(found->second, rect);
+	return true;
+}
+
+bool DKGeometry::DBoundsTracker::offset(uint64_t id, float xAmount, float yAmount)
+{
+	auto found = slots.find(id);
+	if (found == slots.end()) return false;
+
+	DRect rect = tree[leafCount + found->second];
+	rect.Move(xAmount, yAmount);
+	update(found->second, rect);
+	return true;
+}
+
+void DKGeometry::DBoundsTracker::set(const IDRect & rect)
+{
+	if (!move(rect.id, rect)) insert(rect);
+}
+
+bool DKGeometry::DBoundsTracker::get(uint64_t id, DRect & rect) const
+{
+	auto found = slots.find(id);
+	if (found == slots.end()) return false;
+
+	rect = tree[leafCount + found->second];
+	return true;
+}
@@ -0,0 +1,85 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKGeometry.h"
+
+#include <unordered_map>
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Keeps the union bounds of a changing set of IDRects.
+	/// Rects live in slots at the leaves of a segment tree whose inner nodes
+	/// hold the combined rect of their children, so insert, remove and move
+	/// update one root path in O(log n) and bounds() reads the root in O(1).
+	/// Bounds match GetCombinedRect over the same rects; an empty tracker
+	/// reports DRect().</summary>
+	class DBoundsTracker
+	{
+	public:
+		DBoundsTracker() {}
+		explicit DBoundsTracker(const IDRArray&rects);
+
+		// O(n) bulk load, replaces the contents; later duplicates of an id win
+		void assign(const IDRArray&rects);
+		void clear();
+		void reserve(size_t count);
+
+		// false if the id is already tracked
+		bool insert(const IDRect&rect);
+		// false if the id is not tracked
+		bool remove(uint64_t id);
+		bool move(uint64_t id, const DRect&rect);
+		bool offset(uint64_t id, float xAmount, float yAmount);
+		// insert or move
+		void set(const IDRect&rect);
+
+		bool get(uint64_t id, DRect&rect) const;
+		inline bool contains(uint64_t id) const { return slots.count(id) != 0; }
+		inline size_t size() const { return slots.size(); }
+		inline bool isEmpty() const { return slots.empty(); }
+
+		inline DRect bounds() const { return slots.empty() ? DRect() : tree[1]; }
+
+	private:
+		static inline DRect emptyRect() { return DRect(DKInfinity, DKInfinity, DKNegInfinity, DKNegInfinity); }
+		static inline DRect combined(const DRect&a, const DRect&b) {
+			return DRect((std::min)(a.left, b.left), (std::min)(a.top, b.top),
+				(std::max)(a.right, b.right), (std::max)(a.bottom, b.bottom));
+		}
+
+		void grow(size_t capacity);
+		void update(size_t slot, const DRect&rect);
+
+		// tree[1] is the root, leaves start at tree[leafCount]
+		std::vector<DRect> tree;
+		size_t leafCount = 0;
+		size_t usedSlots = 0;
+		std::vector<uint32_t> freeSlots;
+		std::unordered_map<uint64_t, uint32_t> slots;
+	};
+
+}
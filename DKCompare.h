@@ -0,0 +1,265 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKGeometry.h"
+
+namespace DKGeometry
+{
+	// RectComparision bits for CompareRects masks
+	enum DCompareBits : int32_t
+	{
+		DCompareInterference	= 1 << 0,
+		DCompareLeft			= 1 << 1,
+		DCompareRight			= 1 << 2,
+		DCompareTop				= 1 << 3,
+		DCompareBottom			= 1 << 4,
+		DCompareLeftLeft		= 1 << 5,
+		DCompareLeftRight		= 1 << 6,
+		DCompareRightLeft		= 1 << 7,
+		DCompareRightRight		= 1 << 8,
+		DCompareTopTop			= 1 << 9,
+		DCompareTopBottom		= 1 << 10,
+		DCompareBottomTop		= 1 << 11,
+		DCompareBottomBottom	= 1 << 12,
+		DCompareCrossover		= 1 << 13,
+		DCompareAll				= (1 << 14) - 1
+	};
+
+	/// <summary>
+	/// DRect::compareToRect with the wanted bits chosen at compile time.
+	/// Every bit in Mask comes out exactly as compareToRect(rect, SharedEdges)
+	/// would set it; only the comparisons those bits depend on are made, and
+	/// bits outside Mask are unspecified. compareToRect itself is the
+	/// DCompareAll instance.</summary>
+	template <int32_t Mask, bool SharedEdges = false>
+	inline RectComparision CompareRects(const DRect&a, const DRect&rect)
+	{
+		// what each bit depends on; note that bottombottom feeds the right bit
+		// and rightright the rightLeft bit, as compareToRect always did
+		constexpr bool wantLeft = (Mask & DCompareLeft) != 0;
+		constexpr bool wantRight = (Mask & DCompareRight) != 0;
+		constexpr bool wantTop = (Mask & DCompareTop) != 0;
+		constexpr bool wantBottom = (Mask & DCompareBottom) != 0;
+		constexpr bool wantSides = wantLeft || wantRight || wantTop;
+		constexpr bool wantCrossover = (Mask & DCompareCrossover) != 0 || wantSides;
+
+		constexpr bool needLeftLeft = wantLeft || (SharedEdges && (Mask & DCompareLeftLeft));
+		constexpr bool needTopTop = wantTop || (SharedEdges && (Mask & DCompareTopTop));
+		constexpr bool needRightRight = wantRight || (SharedEdges && (Mask & DCompareRightLeft));
+		constexpr bool needBottomBottom = wantRight || (SharedEdges && (wantBottom || (Mask & DCompareBottomBottom)));
+
+		RectComparision result;
+		result.flat = 0;
+
+		int leftright = fCompare(a.left, rect.right);
+		int rightleft = fCompare(a.right, rect.left);
+		int topbottom = fCompare(a.top, rect.bottom);
+		int bottomtop = fCompare(a.bottom, rect.top);
+
+		result.interference = !(
+			rightleft == -1 || leftright == 1 || bottomtop == -1 || topbottom == 1
+			);
+
+		if (result.interference == 0) return result;
+
+		int leftleft = needLeftLeft ? fCompare(a.left, rect.left) : 0;
+		int toptop = needTopTop ? fCompare(a.top, rect.top) : 0;
+		int rightright = needRightRight ? fCompare(a.right, rect.right) : 0;
+		int bottombottom = needBottomBottom ? fCompare(a.bottom, rect.bottom) : 0;
+
+		/**
+			s1: Crosses Right Edge
+			L1   L2   R1   R2
+			| -- | -- | -- |
+			left < rect.left < right < rect.right
+
+			s1a: Crosses Right Edge
+			L1
+			L2   R1   R2
+			| -- | -- |
+
+			left == rect.left < right < rect.right
+
+			s2: Inside
+			L1   L2   R2   R1
+			| -- | -- | -- |
+
+			left < rect.left < rect.right < right
+
+			s2a: Inside
+			L1
+			L2   R2   R1
+			| -- | -- |
+
+			left == rect.left < rect.right < right
+
+			s2b: Inside
+					  R1
+			L1   L2   R2
+			| -- | -- |
+			left < rect.left < rect.right == right
+
+			s2c: Inside
+			L1   R1
+			L2   R2
+			| -- |
+			left == rect.left < rect.right == right
+		
+
+			s3: Crosses Left Edge
+			L2   L1   R2   R1
+			| -- | -- | -- |
+
+			rect.left < left < rect.right < right
+
+			s3a: Crosses Left Edge
+					  R1
+			L2   L1   R2
+			| -- | -- |
+			rect.left < left < right == rect.right
+
+			s4: Outside
+			L2   L1   R1   R2
+			| -- | -- | -- |
+
+			rect.left < left < right < rect.right
+
+			s5: Crosses Both Edges
+			L1   L2   R2   R1
+			| -- | -- | -- |
+			left < rect.left < rect.right < right
+
+			s6: Crosses Both Edges
+			L2   L1   R1   R2
+			| -- | -- | -- |
+			rect.left < left < right < rect.right
+
+		*/
+
+		if (wantCrossover)
+		{
+			result.crossover = (
+				((a.left >= rect.left && a.left < rect.right) || (a.left < rect.left && a.right > rect.left)) &&
+				((a.top >= rect.top && a.top < rect.bottom) || (a.top < rect.top && a.bottom > rect.top))
+				);
+		}
+
+		if (wantSides && result.crossover)
+		{
+			if (wantLeft && leftleft == 1)				result.left = sideStatus::crossover;
+			if (wantTop && toptop == 1)					result.top = sideStatus::crossover;
+			if (wantRight && rightright == -1)			result.right = sideStatus::crossover;
+			if (wantRight && bottombottom == -1)		result.right = sideStatus::crossover;
+		}
+
+		if (SharedEdges)
+		{
+			if (needLeftLeft && !leftleft) {
+				result.left = 1;
+				result.leftLeft = 1;
+			}
+
+			if (!leftright) {
+				result.left = 1;
+				result.leftRight = 1;
+			}
+
+			if (!rightleft) {
+				result.right = 1;
+				result.rightLeft = 1;
+			}
+
+			if (needRightRight && !rightright) {
+				result.right = 1;
+				result.rightLeft = 1;
+			}
+
+			if (needTopTop && !toptop) {
+				result.top = 1;
+				result.topTop = 1;
+			}
+
+			if (!topbottom) {
+				result.top = 1;
+				result.topBottom = 1;
+			}
+
+			if (needBottomBottom && !bottombottom) {
+				result.bottom = 1;
+				result.bottomBottom = 1;
+			}
+
+			if (!bottomtop) {
+				result.bottom = 1;
+				result.bottomTop = 1;
+			}
+		}
+
+		return result;
+	}
+
+	/// <summary>
+	/// Batch form: results[i] = CompareRects<Mask, SharedEdges>(rects[i], rect).</summary>
+	template <int32_t Mask, bool SharedEdges = false>
+	inline void CompareRects(const DRect*rects, size_t count, const DRect&rect, RectComparision*results)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			results[i] = CompareRects<Mask, SharedEdges>(rects[i], rect);
+		}
+	}
+
+	// batch test of a single bit, e.g. TestRects<DCompareCrossover>
+	template <int32_t Bit, bool SharedEdges = false>
+	inline void TestRects(const DRect*rects, size_t count, const DRect&rect, uint8_t*results)
+	{
+		static_assert(Bit && !(Bit & (Bit - 1)), "TestRects takes a single DCompareBits flag");
+		for (size_t i = 0; i < count; i++)
+		{
+			RectComparision comparison = CompareRects<Bit, SharedEdges>(rects[i], rect);
+			uint8_t value = 0;
+			switch (Bit)
+			{
+			case DCompareInterference: value = comparison.interference; break;
+			case DCompareLeft: value = comparison.left; break;
+			case DCompareRight: value = comparison.right; break;
+			case DCompareTop: value = comparison.top; break;
+			case DCompareBottom: value = comparison.bottom; break;
+			case DCompareLeftLeft: value = comparison.leftLeft; break;
+			case DCompareLeftRight: value = comparison.leftRight; break;
+			case DCompareRightLeft: value = comparison.rightLeft; break;
+			case DCompareRightRight: value = comparison.rightRight; break;
+			case DCompareTopTop: value = comparison.topTop; break;
+			case DCompareTopBottom: value = comparison.topBottom; break;
+			case DCompareBottomTop: value = comparison.bottomTop; break;
+			case DCompareBottomBottom: value = comparison.bottomBottom; break;
+			default: value = comparison.crossover; break;
+			}
+			results[i] = value;
+		}
+	}
+
+}
@@ -0,0 +1,230 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKConcurrentIndex.h"
+
+#include <thread>
+
+using namespace DKGeometry;
+
+
+DKGeometry::DConcurrentRectIndex::DConcurrentRectIndex()
+{
+	base = std::make_shared<DRectIndex>();
+	Version*version = new Version();
+	version->base = base;
+	version->number = versionNumber;
+	current.store(version);
+}
+
+DKGeometry::DConcurrentRectIndex::~DConcurrentRectIndex()
+{
+	// readers must be gone by now
+	delete current.load();
+	for (auto&eachRetired : retired)
+	{
+		delete eachRetired.version;
+	}
+}
+
+void DKGeometry::DConcurrentRectIndex::Update(const IDRect & rect)
+{
+	IDRect normalized(rect);
+	normalized.Normalize();
+	live[rect.id] = normalized;
+	pending.insert(rect.id);
+}
+
+void DKGeometry::DConcurrentRectIndex::Remove(uint64_t id)
+{
+	if (live.erase(id)) pending.insert(id);
+}
+
+void DKGeometry::DConcurrentRectIndex::Publish()
+{
+	if (pending.empty())
+	{
+		Reclaim();
+		return;
+	}
+
+	recentChanged.insert(pending.begin(), pending.end());
+	pending.clear();
+
+	Version*version = new Version();
+	version->number = ++versionNumber;
+
+	if (recentChanged.size() > MaxDelta)
+	{
+		layerChanged.insert(recentChanged.begin(), recentChanged.end());
+		recentChanged.clear();
+
+		// rebuild the shared base once the layer would slow every query down
+		size_t threshold = (std::max)((size_t)1024, live.size() / 16);
+		if (layerChanged.size() > threshold)
+		{
+			IDRArray rects;
+			rects.reserve(live.size());
+			for (const auto&eachRect : live) rects.push_back(eachRect.second);
+			base = std::make_shared<DRectIndex>(rects);
+			layer.reset();
+			layerChanged.clear();
+		}
+		else
+		{
+			std::vector<uint64_t> ids(layerChanged.begin(), layerChanged.end());
+			IDRArray rects;
+			rects.reserve(ids.size());
+			for (uint64_t eachId : ids)
+			{
+				auto found = live.find(eachId);
+				if (found != live.end()) rects.push_back(found->second);
+			}
+
+			auto newLayer = std::make_shared<Layer>();
+			newLayer->index.Build(rects);
+			std::sort(ids.begin(), ids.end());
+			newLayer->hidden.assign(std::move(ids));
+			layer = newLayer;
+		}
+	}
+	else
+	{
+		std::vector<uint64_t> ids(recentChanged.begin(), recentChanged.end());
+		std::sort(ids.begin(), ids.end());
+		version->delta.reserve(ids.size());
+		for (uint64_t eachId : ids)
+		{
+			auto found = live.find(eachId);
+			if (found != live.end()) version->delta.push_back(found->second);
+		}
+		version->hidden.assign(std::move(ids));
+	}
+	version->layer = layer;
+	version->base = base;
+
+	Version*old = current.exchange(version);
+	uint64_t epoch = globalEpoch.fetch_add(1) + 1;
+	retired.push_back({ old, epoch });
+
+	Reclaim();
+}
+
+void DKGeometry::DConcurrentRectIndex::IdSet::assign(std::vector<uint64_t>&& sortedIds)
+{
+	ids = std::move(sortedIds);
+
+	// about 16 bits per id keeps false positives near 6%
+	size_t bits = 64;
+	while (bits < ids.size() * 16) bits <<= 1;
+	filter.assign(bits / 64, 0);
+	mask = bits - 1;
+	for (uint64_t eachId : ids)
+	{
+		uint64_t bit = (eachId * 0x9E3779B97F4A7C15ull) >> 32 & mask;
+		filter[bit >> 6] |= uint64_t(1) << (bit & 63);
+	}
+}
+
+size_t DKGeometry::DConcurrentRectIndex::Reclaim()
+{
+	uint64_t oldest = UINT64_MAX;
+	for (auto&eachSlot : slots)
+	{
+		uint64_t epoch = eachSlot.epoch.load();
+		if (epoch && epoch < oldest) oldest = epoch;
+	}
+
+	// a reader that could still hold a version announced an epoch older than its retirement
+	size_t freed = 0;
+	size_t kept = 0;
+	for (auto&eachRetired : retired)
+	{
+		if (eachRetired.epoch <= oldest) {
+			delete eachRetired.version;
+			freed++;
+		}
+		else {
+			retired[kept++] = eachRetired;
+		}
+	}
+	retired.resize(kept);
+	return freed;
+}
+
+
+DKGeometry::DConcurrentRectIndex::Reader::Reader(DConcurrentRectIndex & index)
+	: index(index), slot(0)
+{
+	// slots are only contended while readers are created; wait if all are taken
+	for (;;)
+	{
+		for (size_t i = 0; i < MaxReaders; i++)
+		{
+			bool expected = false;
+			if (!index.slots[i].claimed.load(std::memory_order_relaxed) &&
+				index.slots[i].claimed.compare_exchange_strong(expected, true))
+			{
+				slot = i;
+				return;
+			}
+		}
+		std::this_thread::yield();
+	}
+}
+
+DKGeometry::DConcurrentRectIndex::Reader::~Reader()
+{
+	index.slots[slot].epoch.store(0);
+	index.slots[slot].claimed.store(false, std::memory_order_release);
+}
+
+const DConcurrentRectIndex::Version * DKGeometry::DConcurrentRectIndex::Reader::enter()
+{
+	// announce before loading the version; both are sequentially consistent so
+	// the writer either sees the announcement or this load sees its new version
+	index.slots[slot].epoch.store(index.globalEpoch.load());
+	const Version*version = index.current.load();
+	seenVersion = version->number;
+	return version;
+}
+
+void DKGeometry::DConcurrentRectIndex::Reader::exit()
+{
+	index.slots[slot].epoch.store(0, std::memory_order_release);
+}
+
+size_t DKGeometry::DConcurrentRectIndex::Reader::Count(const DRect & area)
+{
+	size_t count = 0;
+	Visit(area, [&count](const IDRect&) {
+		count++;
+		return true;
+	});
+	return count;
+}
@@ -0,0 +1,208 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKRectIndex.h"
+
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Rect index for one writer thread and many reader threads.
+	///
+	/// The writer batches Update and Remove calls and makes them visible with
+	/// Publish, which swaps in a new immutable version. A version is a shared
+	/// packed DRectIndex, a shared layer indexing the rects changed since that
+	/// base was built, and a small unindexed delta of at most MaxDelta rects
+	/// changed since the layer was built. A full delta is merged into a new
+	/// layer, and the layer into a new base once it passes a fraction of the
+	/// set, so publishing costs O(MaxDelta log MaxDelta) between merges and
+	/// queries never scan more than MaxDelta rects linearly.
+	///
+	/// Readers never lock: each Reader owns a padded epoch slot, announces the
+	/// epoch while it runs a query, and reads whatever version is current.
+	/// Retired versions are freed by the writer once every active reader has
+	/// moved past the epoch they were retired in.</summary>
+	class DConcurrentRectIndex
+	{
+	public:
+		static const size_t MaxReaders = 256;
+		static const size_t MaxDelta = 1024;
+
+		DConcurrentRectIndex();
+		~DConcurrentRectIndex();
+
+		DConcurrentRectIndex(const DConcurrentRectIndex&) = delete;
+		DConcurrentRectIndex& operator=(const DConcurrentRectIndex&) = delete;
+
+		// writer thread only
+		void Update(const IDRect&rect);
+		void Remove(uint64_t id);
+		void Publish();
+		// frees retired versions no reader can still see; Publish calls this too
+		size_t Reclaim();
+
+		inline size_t size() const { return live.size(); }
+		inline size_t pendingCount() const { return pending.size(); }
+		inline size_t retiredCount() const { return retired.size(); }
+
+		// sorted ids with a hashed bit filter in front, so most lookups of ids
+		// that are not in the set cost one bit test instead of a binary search
+		struct IdSet
+		{
+			std::vector<uint64_t> ids;
+			std::vector<uint64_t> filter;
+			uint64_t mask = 0;
+
+			void assign(std::vector<uint64_t>&&sortedIds);
+			inline bool contains(uint64_t id) const {
+				if (ids.empty()) return false;
+				uint64_t bit = (id * 0x9E3779B97F4A7C15ull) >> 32 & mask;
+				if (!(filter[bit >> 6] >> (bit & 63) & 1)) return false;
+				return std::binary_search(ids.begin(), ids.end(), id);
+			}
+		};
+
+		struct Layer
+		{
+			DRectIndex index;	// current rects of the changed ids, normalized
+			IdSet hidden;		// ids whose base entry is stale
+		};
+
+		struct Version
+		{
+			std::shared_ptr<const DRectIndex> base;
+			std::shared_ptr<const Layer> layer;
+			IdSet hidden;		// ids whose base and layer entries are stale
+			IDRArray delta;		// current rects for those ids, normalized
+			uint64_t number;
+		};
+
+		/// <summary>
+		/// Per-thread query handle. Claims an epoch slot for its lifetime, so
+		/// create one per reader thread and keep it rather than one per query.</summary>
+		class Reader
+		{
+		public:
+			explicit Reader(DConcurrentRectIndex&index);
+			~Reader();
+
+			Reader(const Reader&) = delete;
+			Reader& operator=(const Reader&) = delete;
+
+			// visit(item) returns false to stop; the item is only valid inside the call
+			template <class ItemVisitor>
+			void Visit(const DRect&area, ItemVisitor visit)
+			{
+				const Version*version = enter();
+
+				DRect query(area);
+				query.Normalize();
+				const Layer*layer = version->layer.get();
+				bool keepGoing = true;
+				version->base->view().Visit(query, [&](const IDRect&item) {
+					if (version->hidden.contains(item.id) || (layer && layer->hidden.contains(item.id)))
+						return true;
+					keepGoing = visit(item);
+					return keepGoing;
+				});
+				if (keepGoing && layer)
+				{
+					layer->index.view().Visit(query, [&](const IDRect&item) {
+						if (version->hidden.contains(item.id)) return true;
+						keepGoing = visit(item);
+						return keepGoing;
+					});
+				}
+				for (size_t i = 0; keepGoing && i < version->delta.size(); i++)
+				{
+					const IDRect&item = version->delta[i];
+					if (DRectIndexView::touches(item, query)) keepGoing = visit(item);
+				}
+
+				exit();
+			}
+
+			template <class Alloc>
+			void Search(const DRect&area, std::vector<IDRect, Alloc>&results)
+			{
+				Visit(area, [&results](const IDRect&item) {
+					results.push_back(item);
+					return true;
+				});
+			}
+
+			template <class Alloc>
+			void HitTest(const DPoint&point, std::vector<IDRect, Alloc>&results)
+			{
+				Search(DRect(point, point), results);
+			}
+
+			size_t Count(const DRect&area);
+
+			// version number seen by the most recent query
+			inline uint64_t lastVersion() const { return seenVersion; }
+
+		private:
+			const Version* enter();
+			void exit();
+
+			DConcurrentRectIndex&index;
+			size_t slot;
+			uint64_t seenVersion = 0;
+		};
+
+	private:
+		struct alignas(64) EpochSlot
+		{
+			std::atomic<uint64_t> epoch{ 0 };	// 0 while the reader is idle
+			std::atomic<bool> claimed{ false };
+		};
+
+		struct Retired
+		{
+			Version* version;
+			uint64_t epoch;
+		};
+
+		std::atomic<Version*> current;
+		std::atomic<uint64_t> globalEpoch{ 1 };
+		EpochSlot slots[MaxReaders];
+
+		// writer state
+		std::unordered_map<uint64_t, IDRect> live;
+		std::unordered_set<uint64_t> pending;		// changed since the last Publish
+		std::unordered_set<uint64_t> layerChanged;	// changed since the base was built, in the layer
+		std::unordered_set<uint64_t> recentChanged;	// changed since the layer was built
+		std::shared_ptr<const DRectIndex> base;
+		std::shared_ptr<const Layer> layer;
+		std::vector<Retired> retired;
+		uint64_t versionNumber = 0;
+	};
+
+}
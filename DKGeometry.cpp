@@ -27,8 +27,35 @@ SOFTWARE.
 #endif
 
 #include "DKGeometry.h"
+#include "DKCompare.h"
+#include "DKRobust.h"
+#include "DKRangeSet.h"
+#include "DKSceneGraph.h"
+#include "DKSpatialJoin.h"
+#include "DKSnapshot.h"
+#include "DKPolygon.h"
+#include "DKLabelPlacer.h"
+#include "DKTileBinning.h"
+#include "DKSpatialSort.h"
+#include "DKRangeIndex.h"
+#include "DKRectStream.h"
+#include "DKRectText.h"
+#include "DKArena.h"
+#include "DKConcurrentIndex.h"
+#include "DKThreadPool.h"
+#include "DKParallel.h"
+#include "DKBoundsTracker.h"
+#include "DKSnap.h"
+#include "DKOcclusion.h"
+#include "DKQuantized.h"
+#include "DKRectDiff.h"
+#include "DKRayCast.h"
+#include "DKHull.h"
+#include "DKAsyncQuery.h"
+#include "DKRasterize.h"
 
 #include <math.h>
+#include <stdio.h>
 #include <string>
 #include <sstream>
 #include <iostream>
@@ -145,6 +172,49 @@ bool DKGeometry::DRect::Intersects(DRect rect) const
 		);
 }
 
+bool DKGeometry::DLine::containsPointRobust(const DPoint & point) const
+{
+	return PointOnSegment(start, end, point);
+}
+
+bool DKGeometry::DLine::crossesRobust(const DLine & line) const
+{
+	return SegmentsTouch(start, end, line.start, line.end);
+}
+
+bool DKGeometry::DRay::Intersects(const DRect & rect, float & tNear, float tMax) const
+{
+	DRect area(rect);
+	area.Normalize();
+
+	float t0 = 0.f;
+	float t1 = tMax;
+	const float origins[2] = { origin.x, origin.y };
+	const float directions[2] = { direction.x, direction.y };
+	const float lows[2] = { area.left, area.top };
+	const float highs[2] = { area.right, area.bottom };
+
+	for (int axis = 0; axis < 2; axis++)
+	{
+		if (directions[axis] == 0)
+		{
+			// parallel to this slab, so the origin has to lie inside it
+			if (origins[axis] < lows[axis] || origins[axis] > highs[axis]) return false;
+			continue;
+		}
+		float inverse = 1.f / directions[axis];
+		float ta = (lows[axis] - origins[axis]) * inverse;
+		float tb = (highs[axis] - origins[axis]) * inverse;
+		if (ta > tb) std::swap(ta, tb);
+		if (ta > t0) t0 = ta;
+		if (tb < t1) t1 = tb;
+		if (t0 > t1) return false;
+	}
+
+	tNear = t0;
+	return true;
+}
+
 bool DKGeometry::DRect::IsContainedIn(DRect rect) const
 {
 	DRect temp(*this);
@@ -222,165 +292,8 @@ bool DKGeometry::DRect::IsErrorRect() const
 
 DKGeometry::RectComparision DKGeometry::DRect::compareToRect(DRect rect, bool getSharedEdges) const
 {
-	RectComparision result;
-
-	result.flat = 0;
-
-	
-	int leftright = fCompare(left, rect.right);
-	int rightleft = fCompare(right, rect.left);
-	int topbottom = fCompare(top, rect.bottom);
-	int bottomtop = fCompare(bottom, rect.top);
-	int rightright = fCompare(right, rect.right);
-	int bottombottom = fCompare(bottom, rect.bottom);
-
-	result.interference = !(
-		rightleft == -1 || leftright == 1 || bottomtop == -1 || topbottom == 1
-		);
-
-	if (result.interference == 0) return result;
-
-	int leftleft		= fCompare(left,	rect.left);
-	int toptop			= fCompare(top,		rect.top);
-	
-	result.crossover = (
-		(leftleft == 1 && leftright == -1) || leftleft == -1 && rightleft == 1) &&
-		(toptop == 1 && topbottom == -1 || toptop == -1 && bottomtop == 1);
-
-
-	
-	/**
-		s1: Crosses Right Edge
-		L1   L2   R1   R2
-		| -- | -- | -- |
-		left < rect.left < right < rect.right
-
-		s1a: Crosses Right Edge
-		L1
-		L2   R1   R2
-		| -- | -- |
-
-		left == rect.left < right < rect.right
-
-		s2: Inside
-		L1   L2   R2   R1
-		| -- | -- | -- |
-
-		left < rect.left < rect.right < right
-
-		s2a: Inside
-		L1
-		L2   R2   R1
-		| -- | -- |
-
-		left == rect.left < rect.right < right
-
-		s2b: Inside
-				  R1
-		L1   L2   R2
-		| -- | -- |
-		left < rect.left < rect.right == right
-
-		s2c: Inside
-		L1   R1
-		L2   R2
-		| -- |
-		left == rect.left < rect.right == right
-		
-
-		s3: Crosses Left Edge
-		L2   L1   R2   R1
-		| -- | -- | -- |
-
-		rect.left < left < rect.right < right
-
-		s3a: Crosses Left Edge
-				  R1
-		L2   L1   R2
-		| -- | -- |
-		rect.left < left < right == rect.right
-
-		s4: Outside
-		L2   L1   R1   R2
-		| -- | -- | -- |
-
-		rect.left < left < right < rect.right
-
-		s5: Crosses Both Edges
-		L1   L2   R2   R1
-		| -- | -- | -- |
-		left < rect.left < rect.right < right
-
-		s6: Crosses Both Edges
-		L2   L1   R1   R2
-		| -- | -- | -- |
-		rect.left < left < right < rect.right
-
-	*/
-	
-	result.crossover = (
-		((left >= rect.left && left < rect.right) || (left < rect.left && right > rect.left)) &&
-		((top >= rect.top && top < rect.bottom || top < rect.top && bottom > rect.top == 1))
-		);
-
-
-	if (result.crossover)
-	{
-		if (leftleft		==  1)	result.left		= sideStatus::crossover;
-		if (toptop			==  1)	result.top		= sideStatus::crossover;
-		if (rightright		== -1)	result.right	= sideStatus::crossover;
-		if (bottombottom	== -1)	result.right	= sideStatus::crossover;
-	}
-
-
-
-
-
-	if (getSharedEdges) {
-
-		if (!leftleft) {
-			//result.left = sideStatus::sharedSame;
-			result.left = 1;
-			result.leftLeft = 1;
-		}
-
-		if (!leftright) {
-			result.left = 1;
-			result.leftRight = 1;
-		}
-
-		if (!rightleft) {
-			result.right = 1;
-			result.rightLeft = 1;
-		}
-
-		if (!rightright) {
-			result.right = 1;
-			result.rightLeft = 1;
-		}
-
-		if (!toptop) {
-			result.top = 1;
-			result.topTop = 1;
-		}
-
-		if (!topbottom) {
-			result.top = 1;
-			result.topBottom = 1;
-		}
-
-		if (!bottombottom) {
-			result.bottom = 1;
-			result.bottomBottom = 1;
-		}
-
-		if (!bottomtop) {
-			result.bottom = 1;
-			result.bottomTop = 1;
-		}
-	}
-
-	return result;
+	if (getSharedEdges) return CompareRects<DCompareAll, true>(*this, rect);
+	return CompareRects<DCompareAll, false>(*this, rect);
 }
 
 
@@ -393,14 +306,8 @@ DKGeometry::DPoint::DPoint(const DSize & pt)
 
 void DKGeometry::DPoint::fix()
 {
-	float intpart, fractpart;
-
-	fractpart = modff(x, &intpart);
-	x = (fractpart > 0.15f) ? intpart + 0.5f : intpart - 0.5f;
-	
-	fractpart = modff(y, &intpart);
-	y = (fractpart > 0.15f) ? intpart + 0.5f : intpart - 0.5f;
-
+	x = fixDim(x);
+	y = fixDim(y);
 }
 
 void DKGeometry::DPoint::boundInRect(DRect rect)
@@ -413,11 +320,21 @@ void DKGeometry::DPoint::boundInRect(DRect rect)
 
 DRect DKGeometry::GetCombinedRect(const DRectArray & rectarray)
 {
-	if (rectarray.size() == 1) { return rectarray.front(); }
-	DRect cRect = rectarray.front();
-	for (const auto&eachrect : rectarray)
+	return GetCombinedRect(rectarray.data(), rectarray.size());
+}
+
+DRect DKGeometry::GetCombinedRect(const pmr::DRectArray & rectarray)
+{
+	return GetCombinedRect(rectarray.data(), rectarray.size());
+}
+
+DRect DKGeometry::GetCombinedRect(const DRect * rects, size_t count)
+{
+	if (count == 0) { return DRect(); }
+	DRect cRect = rects[0];
+	for (size_t i = 1; i < count; i++)
 	{
-		cRect.CombineWith(eachrect);
+		cRect.CombineWith(rects[i]);
 	}
 	return cRect;
 }
@@ -432,6 +349,24 @@ DRect DKGeometry::INFINITY_RECT()
 	return DRect(-INFINITY,-INFINITY, INFINITY, INFINITY);
 }
 
+// the bits of Mask from CompareRects must match compareToRect, shared edges or not
+template <int32_t Mask>
+static bool comparesLike(const DRect&a, const DRect&b)
+{
+	return (CompareRects<Mask>(a, b).flat & Mask) == (a.compareToRect(b).flat & Mask) &&
+		(CompareRects<Mask, true>(a, b).flat & Mask) == (a.compareToRect(b, true).flat & Mask);
+}
+
+template <int32_t Mask>
+static bool comparesLike(const DRect&a, const DRect*rects, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		if (!comparesLike<Mask>(a, rects[i]) || !comparesLike<Mask>(rects[i], a)) return false;
+	}
+	return true;
+}
+
 bool DKGeometry::test()
 {
 	DRect testRect(100, 100, 200, 200);
@@ -477,6 +412,29 @@ bool DKGeometry::test()
 	ASSERT(testRect.IsContainedIn(DKGeometry::INFINITY_RECT()));
 	ASSERT(testRect.Intersects(DKGeometry::INFINITY_RECT()));
 
+	// CompareRects masks against compareToRect
+	const DRect compareRects[] = {
+		DRect(200, 100, 300, 200),	// touching right
+		DRect(100, 200, 200, 300),	// touching bottom
+		DRect(200, 200, 300, 300),	// touching corner
+		DRect(0, 100, 100, 200),	// touching left
+		DRect(110, 110, 190, 190),	// nested inside
+		DRect(100, 100, 150, 200),	// nested, sharing edges
+		DRect(90, 90, 210, 210),	// nesting
+		DRect(150, 150, 250, 250),	// overlap
+		DRect(300, 300, 400, 400),	// disjoint
+		DRect(100, 100, 200, 200)	// same rect
+	};
+	const size_t compareCount = sizeof(compareRects) / sizeof(compareRects[0]);
+	ASSERT(comparesLike<DCompareInterference>(testRect, compareRects, compareCount));
+	ASSERT(comparesLike<DCompareCrossover>(testRect, compareRects, compareCount));
+	ASSERT(comparesLike<DCompareLeft | DCompareTop>(testRect, compareRects, compareCount));
+	ASSERT(comparesLike<DCompareRight>(testRect, compareRects, compareCount));
+	ASSERT(comparesLike<DCompareBottom>(testRect, compareRects, compareCount));
+	ASSERT(comparesLike<DCompareBottomBottom | DCompareRightLeft>(testRect, compareRects, compareCount));
+	ASSERT(comparesLike<DCompareLeftLeft | DCompareLeftRight | DCompareTopTop | DCompareTopBottom>(testRect, compareRects, compareCount));
+	ASSERT(comparesLike<DCompareAll>(testRect, compareRects, compareCount));
+
 	// Line Tests
 	ASSERT(slantLine1.crosses(slantLine2)); // test obvious line cross
 	ASSERT(horizontalLine.crosses(slantLine1));
@@ -493,6 +451,646 @@ bool DKGeometry::test()
 	ASSERT(verticalLine.crosses(infHorizLine));
 	ASSERT(infHorizLine.crosses(infVertLine));
 
+	// Robust predicates on nearly collinear and touching segments
+	float justAbove = nextafterf(1.f, 2.f);
+	float justBelow = nextafterf(24.f, 0.f);
+	ASSERT(Orient2D(DPoint(0, 0), DPoint(3, 3), DPoint(1, 1)) == 0);
+	ASSERT(Orient2D(DPoint(0, 0), DPoint(3, 3), DPoint(1, justAbove)) == 1);
+	ASSERT(Orient2D(DPoint(0, 0), DPoint(3, 3), DPoint(justAbove, 1)) == -1);
+	ASSERT(Orient2D(DPoint(0.5f, 0.5f), DPoint(12, 12), DPoint(24, 24)) == 0);
+	ASSERT(Orient2D(DPoint(0.5f, 0.5f), DPoint(12, 12), DPoint(24, justBelow)) == -1);
+	ASSERT(Orient2D(DPoint(12, 12), DPoint(0.5f, 0.5f), DPoint(24, justBelow)) == 1);
+
+	DLine diagonal(DPoint(0, 0), DPoint(1, 1));
+	DLine touchingEnd(DPoint(1, 1), DPoint(2, 0));	// shares an endpoint
+	DLine nearEnd(DPoint(1, justAbove), DPoint(2, 2));	// starts one ulp past the end
+	DLine overlapping(DPoint(0.5f, 0.5f), DPoint(3, 3));	// collinear overlap
+	DLine beyond(DPoint(2, 2), DPoint(3, 3));	// collinear, disjoint
+	DLine base(DPoint(0, 0), DPoint(2, 0));
+	DLine onBase(DPoint(1, 0), DPoint(1, 1));	// endpoint inside base
+	DLine overBase(DPoint(1, FLT_MIN), DPoint(1, 1));	// just above base
+	ASSERT(SegmentsTouch(diagonal.start, diagonal.end, touchingEnd.start, touchingEnd.end));
+	ASSERT(!SegmentsTouch(diagonal.start, diagonal.end, nearEnd.start, nearEnd.end));
+	ASSERT(SegmentsTouch(diagonal.start, diagonal.end, overlapping.start, overlapping.end));
+	ASSERT(!SegmentsTouch(diagonal.start, diagonal.end, beyond.start, beyond.end));
+	ASSERT(SegmentsTouch(base.start, base.end, onBase.start, onBase.end));
+	ASSERT(!SegmentsTouch(base.start, base.end, overBase.start, overBase.end));
+	ASSERT(diagonal.crosses(touchingEnd, DPredicateRobust));
+	ASSERT(!diagonal.crosses(nearEnd, DPredicateRobust));
+	ASSERT(diagonal.crosses(overlapping, DPredicateRobust));
+	ASSERT(overlapping.crosses(diagonal, DPredicateRobust));
+	ASSERT(!diagonal.crosses(beyond, DPredicateRobust));
+	ASSERT(base.crosses(onBase, DPredicateRobust));
+	ASSERT(!base.crosses(overBase, DPredicateRobust));
+	ASSERT(overlapping.containsPoint(DPoint(1, 1), DPredicateRobust));
+	ASSERT(!overlapping.containsPoint(DPoint(1, justAbove), DPredicateRobust));
+	ASSERT(!diagonal.containsPoint(DPoint(2, 2), DPredicateRobust));
+	DPoint notANumber(NAN, 0.5f);
+	ASSERT(!SegmentsTouch(diagonal.start, diagonal.end, notANumber, DPoint(1, 0)));
+	ASSERT(!SegmentsTouch(notANumber, notANumber, diagonal.start, diagonal.end));
+	ASSERT(!SegmentsIntersect(diagonal.start, diagonal.end, DPoint(0, 1), notANumber));
+	ASSERT(!PointOnSegment(diagonal.start, notANumber, diagonal.start));
+
+	// Range set tests
+	DRangeSet rangeSet;
+	rangeSet.add(DRange(10, 5));
+	rangeSet.add(DRange(20, 5));
+	rangeSet.add(DRange(15, 2)); // touches [10, 15) and merges with it
+	ASSERT(rangeSet.size() == 2 && rangeSet[0] == DRange(10, 7) && rangeSet[1] == DRange(20, 5));
+	rangeSet.remove(DRange(12, 10));
+	ASSERT(rangeSet.size() == 2 && rangeSet[0] == DRange(10, 2) && rangeSet[1] == DRange(22, 3));
+	ASSERT(rangeSet.contains(11) && !rangeSet.contains(12) && !rangeSet.contains(25));
+	ASSERT(rangeSet.contains(DRange(22, 3)) && !rangeSet.contains(DRange(21, 2)));
+	ASSERT(rangeSet.intersects(DRange(0, 11)) && !rangeSet.intersects(DRange(12, 10)));
+	DRange otherRanges[] = { DRange(11, 12) };
+	DRangeSet otherSet(otherRanges, 1);
+	ASSERT((rangeSet | otherSet).size() == 1 && (rangeSet | otherSet)[0] == DRange(10, 15));
+	ASSERT((rangeSet & otherSet).size() == 2 && (rangeSet & otherSet).coverage() == 2);
+	ASSERT((rangeSet - otherSet).size() == 2 && (rangeSet - otherSet)[0] == DRange(10, 1) && (rangeSet - otherSet)[1] == DRange(23, 2));
+
+	// ranges reaching UINT32_MAX saturate rather than wrap
+	ASSERT(DRange(UINT32_MAX - 2, 10).limit() == UINT32_MAX);
+	DRangeSet edgeSet;
+	edgeSet.add(DRange(10, 5));
+	edgeSet.remove(DRange(UINT32_MAX, 5));
+	ASSERT(edgeSet.size() == 1 && edgeSet[0] == DRange(10, 5));
+	ASSERT(!edgeSet.contains(UINT32_MAX) && !edgeSet.intersects(DRange(UINT32_MAX, 1)));
+	edgeSet.add(DRange(UINT32_MAX - 5, 10));
+	ASSERT(edgeSet.contains(UINT32_MAX - 1) && !edgeSet.contains(UINT32_MAX));
+	ASSERT(edgeSet.intersects(DRange(UINT32_MAX - 1, 1)) && !edgeSet.intersects(DRange(UINT32_MAX, 1)));
+	edgeSet.remove(DRange(UINT32_MAX - 3, 10));
+	ASSERT(edgeSet.size() == 2 && edgeSet[1] == DRange(UINT32_MAX - 5, 2));
+
+	// the batch intersect agrees with DRange::intersect
+	DRange batchA[] = { DRange(0, 10), DRange(5, 10), DRange(UINT32_MAX - 4, 10), DRange(20, 0), DRange(30, 5) };
+	DRange batchB[] = { DRange(5, 10), DRange(0, 3), DRange(UINT32_MAX - 8, 6), DRange(20, 5), DRange(30, 5) };
+	DRange batchOut[5];
+	IntersectRanges(batchA, batchB, batchOut, 5);
+	for (int i = 0; i < 5; i++) ASSERT(batchOut[i] == batchA[i].intersect(batchB[i]));
+
+	// Scene graph tests
+	DSceneGraph sceneGraph;
+	DRect worldRect;
+	ASSERT(sceneGraph.insert(IDRect(DRect(0, 0, 10, 10), 1), DPoint(100, 100)));
+	ASSERT(sceneGraph.insertChild(1, IDRect(DRect(0, 0, 5, 5), 2), DPoint(10, 10)));
+	ASSERT(sceneGraph.insertChild(2, IDRect(DRect(0, 0, 1, 1), 3), DPoint(1, 1)));
+	ASSERT(!sceneGraph.insert(IDRect(DRect(0, 0, 1, 1), 3)) && !sceneGraph.insertChild(9, IDRect(DRect(), 4)));
+	ASSERT(sceneGraph.getWorldRect(3, worldRect) && worldRect == DRect(111, 111, 112, 112));
+	ASSERT(sceneGraph.setOffset(1, DPoint(0, 0)));
+	ASSERT(sceneGraph.getWorldRect(3, worldRect) && worldRect == DRect(11, 11, 12, 12));
+	ASSERT(sceneGraph.getSubtreeBounds(1, worldRect) && worldRect == DRect(0, 0, 15, 15));
+	ASSERT(!sceneGraph.setParent(1, 3)); // 3 is inside the subtree of 1
+	ASSERT(sceneGraph.setParent(3, 1));
+	ASSERT(sceneGraph.getWorldRect(3, worldRect) && worldRect == DRect(1, 1, 2, 2));
+	ASSERT(sceneGraph.getSubtreeBounds(2, worldRect) && worldRect == DRect(10, 10, 15, 15));
+	ASSERT(sceneGraph.makeTopLevel(2) && sceneGraph.offsetBy(1, 50, 0));
+	ASSERT(sceneGraph.getWorldRect(2, worldRect) && worldRect == DRect(10, 10, 15, 15));
+	ASSERT(sceneGraph.bounds() == DRect(10, 0, 60, 15));
+	std::vector<uint64_t> sceneIds;
+	sceneGraph.Search(DRect(50, 0, 52, 2), sceneIds);
+	ASSERT(sceneIds.size() == 2 && sceneIds[0] == 1 && sceneIds[1] == 3);
+	ASSERT(sceneGraph.remove(1) && sceneGraph.size() == 1 && !sceneGraph.contains(3));
+	ASSERT(sceneGraph.bounds() == DRect(10, 10, 15, 15));
+
+	// Spatial join tests, against every pair, with an infinite rect in the mix
+	IDRArray joinLeft, joinRight;
+	for (int i = 0; i < 300; i++)
+	{
+		float x = (float)((i * 37) % 400), y = (float)((i * 53) % 400);
+		joinLeft.push_back(IDRect(DRect(x, y, x + (i % 7) * 5, y + (i % 5) * 6), i));
+		joinRight.push_back(IDRect(DRect(y, x, y + (i % 3) * 9, x + (i % 4) * 7), 1000 + i));
+	}
+	for (int pass = 0; pass < 2; pass++)
+	{
+		std::vector<std::pair<uint64_t, uint64_t>> joined, expected;
+		DJoinPairArray joinPairs;
+		SpatialJoin(joinLeft, joinRight, joinPairs);
+		for (const auto&eachPair : joinPairs) joined.push_back(std::make_pair(eachPair.leftId, eachPair.rightId));
+		for (const auto&eachLeft : joinLeft)
+			for (const auto&eachRight : joinRight)
+				if (eachLeft.Intersects(eachRight)) expected.push_back(std::make_pair(eachLeft.id, eachRight.id));
+		std::sort(joined.begin(), joined.end());
+		std::sort(expected.begin(), expected.end());
+		ASSERT(joined == expected);
+		joinLeft.push_back(IDRect(DKGeometry::INFINITY_RECT(), 500));
+	}
+
+	// Packed index tests, against a linear scan
+	IDRArray indexRects;
+	for (int i = 0; i < 700; i++)
+	{
+		float x = (float)((i * 71) % 500), y = (float)((i * 29) % 500);
+		indexRects.push_back(IDRect(DRect(x + (i % 9) * 4, y, x, y + (i % 6) * 5), i)); // some unnormalized
+	}
+	const DRect indexAreas[] = { DRect(0, 0, 50, 50), DRect(100, 200, 300, 210), DRect(250, 250, 250, 250), DRect(-10, -10, -5, -5), DKGeometry::INFINITY_RECT() };
+	DRectIndex rectIndex(indexRects);
+	for (const auto&eachArea : indexAreas)
+	{
+		size_t expected = 0;
+		for (auto eachRect : indexRects)
+		{
+			eachRect.Normalize();
+			if (eachRect.Intersects(eachArea)) expected++;
+		}
+		ASSERT(rectIndex.Count(eachArea) == expected);
+	}
+
+	// snapshots open with the same index; SoA views have no items to visit
+	const char* snapshotPath = "DKGeometryTest.snapshot";
+	DRectSnapshot snapshot;
+	ASSERT(WriteRectSnapshot(snapshotPath, rectIndex) && snapshot.Open(snapshotPath));
+	ASSERT(snapshot.size() == indexRects.size() && snapshot.bounds() == rectIndex.bounds());
+	for (const auto&eachArea : indexAreas) ASSERT(snapshot.index().Count(eachArea) == rectIndex.Count(eachArea));
+	snapshot.Close();
+	ASSERT(WriteRectSnapshot(snapshotPath, rectIndex, DSnapshotSoA) && snapshot.Open(snapshotPath));
+	ASSERT(snapshot.layout() == DSnapshotSoA && snapshot.index().Count(DKGeometry::INFINITY_RECT()) == 0);
+	size_t leafItems = 0;
+	snapshot.index().VisitLeaves(DKGeometry::INFINITY_RECT(), [&](uint32_t, uint32_t count) {
+		leafItems += count;
+		return true;
+	});
+	ASSERT(leafItems == indexRects.size() && snapshot.ids().size() == indexRects.size());
+	snapshot.Close();
+	remove(snapshotPath);
+
+	// Label placement tests: alternatives share an id, touching is no overlap
+	DLabelPlacer labelPlacer;
+	labelPlacer.addObstacle(DRect(-1e30f, 50, 1e30f, 60));
+	DLabelCandidateArray labelCandidates = {
+		{ IDRect(DRect(0, 0, 10, 10), 1), 5 },
+		{ IDRect(DRect(5, 5, 15, 15), 2), 4 },	// overlaps 1
+		{ IDRect(DRect(10, 0, 20, 10), 2), 3 },	// touches 1
+		{ IDRect(DRect(0, 55, 10, 65), 3), 2 },	// inside the obstacle
+		{ IDRect(DRect(20, 45, 30, 55), 3), 1 }
+	};
+	IDRArray placedLabels;
+	DLabelResult labelResult = labelPlacer.Place(labelCandidates, placedLabels);
+	ASSERT(labelResult.placed == 2 && labelResult.dropped == 1 && !labelResult.timedOut);
+	ASSERT(placedLabels.size() == 2 && placedLabels[0].id == 1 && placedLabels[1] == DRect(10, 0, 20, 10));
+
+	// Tile binning tests: half-open tile edges, touching from outside is skipped
+	IDRArray binInput = {
+		IDRect(DRect(10, 10, 20, 20), 10), IDRect(DRect(40, 40, 60, 60), 11), IDRect(DRect(50, 0, 100, 50), 12),
+		IDRect(DRect(-10, 0, 0, 10), 13), IDRect(DRect(75, 75, 75, 75), 14), IDRect(DRect(200, 200, 300, 300), 15)
+	};
+	DTileBins tileBins;
+	BinRects(binInput, DRect(0, 0, 100, 100), 50, tileBins);
+	ASSERT(tileBins.columns == 2 && tileBins.rows == 2 && tileBins.ids.size() == 7);
+	ASSERT(tileBins.binSize(0) == 2 && tileBins.bin(0)[0] == 10 && tileBins.bin(0)[1] == 11);
+	ASSERT(tileBins.binSize(1) == 2 && tileBins.bin(1)[0] == 11 && tileBins.bin(1)[1] == 12);
+	ASSERT(tileBins.binSize(2) == 1 && tileBins.bin(2)[0] == 11);
+	ASSERT(tileBins.binSize(3) == 2 && tileBins.bin(3)[0] == 11 && tileBins.bin(3)[1] == 14);
+	DTileBins plainBins;
+	BinRects(DRectArray(binInput.begin(), binInput.end()), DRect(0, 0, 100, 100), 50, plainBins);
+	ASSERT(plainBins.offsets == tileBins.offsets && plainBins.ids[6] == 4);
+
+	// Spatial sort tests: quadrant order of each curve, same order for both array types
+	ASSERT(MortonKey(1, 0) == 1 && MortonKey(0, 1) == 2 && MortonKey(3, 3) == 15);
+	IDRArray curveRects = {
+		IDRect(DRect(90, 90, 100, 100), 3), IDRect(DRect(0, 90, 10, 100), 2),
+		IDRect(DRect(90, 0, 100, 10), 1), IDRect(DRect(0, 0, 10, 10), 0)
+	};
+	IDRArray mortonRects(curveRects), hilbertRects(curveRects);
+	SpatialSort(mortonRects, DCurveMorton);
+	SpatialSort(hilbertRects, DCurveHilbert);
+	ASSERT(mortonRects[0].id == 0 && mortonRects[1].id == 1 && mortonRects[2].id == 2 && mortonRects[3].id == 3);
+	ASSERT(hilbertRects[0].id == 0 && hilbertRects[1].id == 2 && hilbertRects[2].id == 3 && hilbertRects[3].id == 1);
+	DRectArray plainRects(indexRects.begin(), indexRects.end());
+	IDRArray sortedRects(indexRects);
+	SpatialSort(plainRects);
+	SpatialSort(sortedRects);
+	bool sameOrder = plainRects.size() == sortedRects.size();
+	for (size_t i = 0; sameOrder && i < plainRects.size(); i++) sameOrder = plainRects[i] == sortedRects[i];
+	ASSERT(sameOrder);
+
+	// Polyline and polygon tests, chunked queries against every segment
+	DPointArray zigzag;
+	for (int i = 0; i < 100; i++) zigzag.push_back(DPoint(i * 10.f, (i % 2) * 10.f));
+	DPolyline polyline(zigzag);
+	ASSERT(polyline.bounds() == DRect(0, 0, 990, 10) && polyline.chunkCount() > 1);
+	ASSERT(fabsf(polyline.length() - 99 * sqrtf(200.f)) < 0.01f);
+	const DRect polylineAreas[] = { DRect(3, 5, 4, 6), DRect(3, 0, 4, 1), DRect(495, -5, 496, 15), DRect(0, 20, 990, 30), DRect(985, 9, 995, 20) };
+	for (const auto&eachArea : polylineAreas)
+	{
+		bool expected = false;
+		for (size_t i = 0; i < polyline.segmentCount(); i++)
+		{
+			DLine segment = polyline.segment(i);
+			expected = expected || SegmentIntersectsRect(segment.start, segment.end, eachArea);
+		}
+		ASSERT(polyline.Intersects(eachArea) == expected);
+	}
+	ASSERT(!polyline.Intersects(DRect(3, 5, 4, 6)) && polyline.Intersects(DRect(495, -5, 496, 15)));
+
+	DPolygon lShape(DPointArray{ DPoint(0, 0), DPoint(100, 0), DPoint(100, 50), DPoint(50, 50), DPoint(50, 100), DPoint(0, 100) });
+	ASSERT(lShape.segmentCount() == 6 && fabsf(lShape.area()) == 7500);
+	ASSERT(lShape.PointInPolygon(DPoint(25, 75)) && !lShape.PointInPolygon(DPoint(75, 75)));
+	ASSERT(lShape.Intersects(DRect(10, 10, 20, 20)) && lShape.Intersects(DRect(-10, -10, 200, 200)));
+	ASSERT(!lShape.Intersects(DRect(60, 60, 90, 90)) && !lShape.Intersects(DRect(200, 0, 300, 10)));
+
+	// Range index tests, against a scan of the added ranges
+	DRangeIndex rangeIndex;
+	std::vector<DRange> indexedRanges;
+	for (uint32_t i = 0; i < 300; i++)
+	{
+		indexedRanges.push_back(DRange((i * 97) % 1000, 1 + (i * 13) % 40));
+		rangeIndex.add(indexedRanges.back(), i);
+	}
+	for (uint32_t position = 0; position < 1050; position += 7)
+	{
+		std::vector<uint64_t> stabbed, overlapped;
+		rangeIndex.stab(position, stabbed);
+		rangeIndex.overlapping(DRange(position, 5), overlapped);
+		size_t expectedStab = 0, expectedOverlap = 0;
+		for (const auto&eachRange : indexedRanges)
+		{
+			if (eachRange.start <= position && position < eachRange.limit()) expectedStab++;
+			if (eachRange.start < position + 5 && position < eachRange.limit()) expectedOverlap++;
+		}
+		ASSERT(stabbed.size() == expectedStab && overlapped.size() == expectedOverlap);
+	}
+
+	// edits: insertion at a range end extends it, at its start shifts it,
+	// and a range deleted entirely stops matching
+	DRangeIndex editIndex;
+	editIndex.add(DRange(10, 10), 1);
+	editIndex.add(DRange(30, 5), 2);
+	editIndex.add(DRange(45, 5), 3);
+	editIndex.insertText(20, 5);
+	editIndex.deleteText(35, 5);
+	editIndex.insertText(10, 3);
+	std::vector<uint64_t> editIds;
+	editIndex.stab(27, editIds);
+	ASSERT(editIds.size() == 1 && editIds[0] == 1);
+	editIds.clear();
+	editIndex.overlapping(DRange(28, 100), editIds);
+	ASSERT(editIds.size() == 1 && editIds[0] == 3);
+	DRangeHitArray editHits;
+	editIndex.applyEdits();
+	editIndex.stab(50, editHits);
+	ASSERT(editHits.size() == 1 && editHits[0].range == DRange(48, 5));
+
+	// Rect stream tests: chunked stages agree with one pass over the whole array
+	const DRect streamArea(100, 100, 400, 400);
+	IDRArray streamExpected;
+	for (const auto&eachRect : indexRects)
+	{
+		DRect normal(eachRect);
+		normal.Normalize();
+		if (normal.Intersects(streamArea)) streamExpected.push_back(eachRect);
+	}
+	size_t expectedOverlaps = 0;
+	for (size_t i = 0; i < streamExpected.size(); i++)
+	{
+		for (size_t j = i + 1; j < streamExpected.size() && j - i <= 5; j++)
+		{
+			DRect first(streamExpected[i]), second(streamExpected[j]);
+			first.Normalize();
+			second.Normalize();
+			if (first.Intersects(second)) expectedOverlaps++;
+		}
+	}
+	DRect streamBounds;
+	size_t streamCount = 0, streamOverlaps = 0;
+	IDRectStream stream(64);
+	stream.filterIntersects(streamArea)
+		.combineBounds(streamBounds)
+		.detectOverlaps(5, [&](uint64_t, uint64_t) { streamOverlaps++; })
+		.sink([&](const IDRect*, size_t count) { streamCount += count; return true; });
+	ASSERT(stream.run(IDRectStream::FromArray(indexRects.data(), indexRects.size())) == indexRects.size());
+	ASSERT(streamCount == streamExpected.size() && streamOverlaps == expectedOverlaps);
+	ASSERT(streamBounds == GetCombinedRect(DRectArray(streamExpected.begin(), streamExpected.end())));
+
+	// Text tests: every format reads back the identical values, also in pieces
+	IDRArray textRects = {
+		IDRect(DRect(0.1f, -1e-30f, 3.4e38f, 1.f / 3), UINT64_MAX), IDRect(DRect(-5, 0, 1e7f, 123.456f), 7)
+	};
+	char textBuffer[512];
+	for (int format = DTextPlain; format <= DTextJSON; format++)
+	{
+		ASSERT(MaxFormattedSize(textRects.size(), 4, true) <= sizeof(textBuffer));
+		DTextResult formatted = FormatRects(textRects.data(), textRects.size(), textBuffer, sizeof(textBuffer), (DTextFormat)format);
+		IDRArray parsedRects;
+		DTextResult parsed = ParseRects(textBuffer, formatted.bytes, parsedRects);
+		ASSERT(formatted.count == 2 && parsed.count == 2 && parsedRects.size() == 2);
+		for (size_t i = 0; i < 2; i++) ASSERT(parsedRects[i] == textRects[i] && parsedRects[i].id == textRects[i].id);
+	}
+	DTextResult firstPart = FormatRects(textRects.data(), textRects.size(), textBuffer, 60, DTextCSV);
+	ASSERT(firstPart.count == 1);
+	DTextResult secondPart = FormatRects(textRects.data() + 1, 1, textBuffer + firstPart.bytes, sizeof(textBuffer) - firstPart.bytes, DTextCSV);
+	size_t textLength = firstPart.bytes + secondPart.bytes;
+	IDRArray pieceRects;
+	DTextResult firstPiece = ParseRects(textBuffer, textLength / 2, pieceRects, false);
+	ParseRects(textBuffer + firstPiece.bytes, textLength - firstPiece.bytes, pieceRects);
+	ASSERT(pieceRects.size() == 2 && pieceRects[1] == textRects[1] && pieceRects[0].id == UINT64_MAX);
+
+	// Arena tests: pmr results match, and a reset arena is reused without growing
+	DFrameArena frameArena(1024);
+	size_t arenaCapacity = 0;
+	for (int frame = 0; frame < 3; frame++)
+	{
+		frameArena.reset();
+		ASSERT(frameArena.bytesAllocated() == 0);
+		pmr::IDRArray arenaResults(&frameArena);
+		rectIndex.Search(DRect(0, 0, 250, 250), arenaResults);
+		ASSERT(arenaResults.size() == rectIndex.Count(DRect(0, 0, 250, 250)) && frameArena.bytesAllocated() > 0);
+		pmr::DRectArray arenaRects(arenaResults.begin(), arenaResults.end(), &frameArena);
+		ASSERT(GetCombinedRect(arenaRects) == GetCombinedRect(DRectArray(arenaResults.begin(), arenaResults.end())));
+		if (frame == 1) arenaCapacity = frameArena.capacity();
+		if (frame == 2) ASSERT(frameArena.capacity() == arenaCapacity);
+	}
+	ASSERT(GetCombinedRect(pmr::DRectArray(&frameArena)) == DRect());
+
+	// Concurrent index tests: published versions match a plain model, across
+	// delta, layer and base rebuilds
+	DConcurrentRectIndex concurrentIndex;
+	std::vector<DRect> concurrentModel(3000);
+	std::vector<bool> concurrentLive(concurrentModel.size(), false);
+	for (int round = 0; round < 4; round++)
+	{
+		size_t changes = round == 0 ? concurrentModel.size() : 700 * round;
+		for (size_t i = 0; i < changes; i++)
+		{
+			size_t id = (i * 7919 + round * 31) % concurrentModel.size();
+			if (round > 0 && i % 5 == 0) {
+				concurrentIndex.Remove(id);
+				concurrentLive[id] = false;
+				continue;
+			}
+			float x = (float)((id * 37 + round * 101) % 1000), y = (float)((id * 61 + round * 17) % 1000);
+			concurrentModel[id] = DRect(x, y, x + 8, y + 8);
+			concurrentLive[id] = true;
+			concurrentIndex.Update(IDRect(concurrentModel[id], id));
+		}
+		DConcurrentRectIndex::Reader concurrentReader(concurrentIndex);
+		size_t beforePublish = concurrentReader.Count(DKGeometry::INFINITY_RECT());
+		concurrentIndex.Publish();
+		ASSERT(round > 0 || beforePublish == 0);
+		for (const auto&eachArea : { DRect(0, 0, 100, 100), DRect(500, 0, 1000, 300), DKGeometry::INFINITY_RECT() })
+		{
+			size_t expected = 0;
+			for (size_t i = 0; i < concurrentModel.size(); i++)
+				if (concurrentLive[i] && concurrentModel[i].Intersects(eachArea)) expected++;
+			ASSERT(concurrentReader.Count(eachArea) == expected);
+		}
+	}
+	ASSERT(concurrentIndex.size() < concurrentModel.size());
+
+	// Executor tests: every chunk runs once, nested loops finish, and batch
+	// results match the serial ones on any executor
+	DThreadPool threadPool(3);
+	std::vector<uint8_t> chunkHits(10000, 0);
+	threadPool.parallelFor(chunkHits.size() / 100, 1, [&](size_t begin, size_t end) {
+		for (size_t outer = begin; outer < end; outer++)
+		{
+			threadPool.parallelFor(100, 7, [&](size_t first, size_t last) {
+				ASSERT(first % 7 == 0 && last == (std::min)(first + 7, (size_t)100));
+				for (size_t i = first; i < last; i++) chunkHits[outer * 100 + i]++;
+			});
+		}
+	});
+	ASSERT(std::count(chunkHits.begin(), chunkHits.end(), 1) == (ptrdiff_t)chunkHits.size());
+	DInlineExecutor inlineExecutor;
+	DRect poolBounds = GetCombinedRect(plainRects, threadPool, 64);
+	ASSERT(poolBounds == GetCombinedRect(plainRects) && poolBounds == GetCombinedRect(plainRects, inlineExecutor));
+	std::vector<uint8_t> poolHits(plainRects.size());
+	IntersectsRect(plainRects.data(), plainRects.size(), DRect(100, 100, 200, 200), poolHits.data(), threadPool, 32);
+	bool poolMatches = true;
+	for (size_t i = 0; i < plainRects.size(); i++) poolMatches = poolMatches && (poolHits[i] != 0) == plainRects[i].Intersects(DRect(100, 100, 200, 200));
+	ASSERT(poolMatches);
+
+	// Bounds tracker tests: insert, move, offset and remove match GetCombinedRect
+	DBoundsTracker boundsTracker;
+	DRectArray trackedRects;
+	for (size_t i = 0; i < 40; i++)
+	{
+		trackedRects.push_back(plainRects[i]);
+		ASSERT(boundsTracker.insert(IDRect(plainRects[i], i)));
+	}
+	ASSERT(!boundsTracker.insert(IDRect(DRect(), 3)) && boundsTracker.bounds() == GetCombinedRect(trackedRects));
+	ASSERT(boundsTracker.move(5, DRect(-50, -60, -40, -30)));
+	trackedRects[5] = DRect(-50, -60, -40, -30);
+	ASSERT(boundsTracker.bounds() == GetCombinedRect(trackedRects));
+	ASSERT(boundsTracker.offset(5, 1000, 1000));
+	trackedRects[5].Move(1000, 1000);
+	ASSERT(boundsTracker.bounds() == GetCombinedRect(trackedRects));
+	ASSERT(boundsTracker.remove(5) && !boundsTracker.remove(5) && !boundsTracker.contains(5));
+	trackedRects.erase(trackedRects.begin() + 5);
+	ASSERT(boundsTracker.bounds() == GetCombinedRect(trackedRects) && boundsTracker.size() == 39);
+	boundsTracker.clear();
+	ASSERT(boundsTracker.bounds() == DRect());
+
+	// Snap tests: the batch kernels match the scalar fixes and each mode's rule
+	DRectArray snapRects, fixedRects;
+	for (int i = 0; i < 7; i++)
+	{
+		snapRects.push_back(DRect(i * 1.3f - 4, i * 0.7f, i * 2.45f + 0.5f, i * 3.1f + 0.25f));
+		fixedRects.push_back(snapRects.back());
+		fixedRects.back().fix();
+	}
+	SnapRects(snapRects);
+	ASSERT(snapRects == fixedRects);
+	DRectArray modeRects = { DRect(2.5f, 3.5f, -2.5f, 0.2f), DRect(0.2f, 0.7f, 1.2f, 1.1f) };
+	SnapRects(modeRects, DSnapNearest);
+	ASSERT(modeRects[0] == DRect(2, 4, -2, 0) && modeRects[1] == DRect(0, 1, 1, 1));
+	modeRects[1] = DRect(0.2f, 0.7f, 1.2f, 1.1f);
+	SnapRects(modeRects.data() + 1, 1, DSnapOutward);
+	ASSERT(modeRects[1] == DRect(0, 0, 2, 2));
+	modeRects[1] = DRect(0.3f, 0.3f, 0.3f, 0.3f);
+	SnapRects(modeRects.data() + 1, 1, DSnapNearest, 2.f);
+	ASSERT(modeRects[1] == DRect(0.5f, 0.5f, 0.5f, 0.5f));
+	DPointArray snapPoints = { DPoint(-0.5f, 1.9f), DPoint(3.2f, -2.2f) };
+	SnapPoints(snapPoints, DSnapOutward);
+	ASSERT(snapPoints[0].x == -1 && snapPoints[0].y == 1 && snapPoints[1].x == 3 && snapPoints[1].y == -3);
+
+	// Occlusion tests, back to front: a background hides what is behind it,
+	// a translucent rect hides nothing, an infinite rect on top hides the rest
+	DRect subtractPieces[4];
+	ASSERT(SubtractRect(DRect(0, 0, 100, 100), DRect(10, 10, 50, 50), subtractPieces) == 4);
+	ASSERT(SubtractRect(DRect(0, 0, 100, 100), DRect(-10, -10, 200, 50), subtractPieces) == 1 && subtractPieces[0] == DRect(0, 50, 100, 100));
+	ASSERT(SubtractRect(DRect(0, 0, 10, 10), DRect(10, 0, 20, 10), subtractPieces) == 1); // touching cuts nothing
+	IDRArray layers = {
+		IDRect(DRect(20, 20, 30, 30), 0), IDRect(DRect(0, 0, 100, 100), 1),
+		IDRect(DRect(10, 10, 50, 50), 2), IDRect(DRect(60, 60, 200, 200), 3)
+	};
+	std::vector<uint8_t> layerOpaque = { 1, 1, 1, 0 };
+	std::vector<uint64_t> occludedIds;
+	IDRArray visibleLayers;
+	CullOccluded(layers, layerOpaque, occludedIds, &visibleLayers);
+	ASSERT(occludedIds.size() == 1 && occludedIds[0] == 0);
+	double layerArea[4] = { 0, 0, 0, 0 };
+	for (const auto&eachPart : visibleLayers) layerArea[eachPart.id] += eachPart.area();
+	ASSERT(layerArea[1] == 10000 - 1600 && layerArea[2] == 1600 && layerArea[3] == 140 * 140);
+	layers.push_back(IDRect(DKGeometry::INFINITY_RECT(), 4));
+	occludedIds.clear();
+	CullOccluded(layers, occludedIds);
+	ASSERT(occludedIds.size() == 4 && occludedIds[3] == 3);
+
+	// Quantized tests: decoding is conservative and the compact index never misses
+	DQuantizedFrame quantizedFrame(DRect(-100, -100, 900, 700));
+	DRect quantizedRect(12.34f, -56.78f, 90.12f, 345.67f);
+	DRect decodedRect = quantizedFrame.decode(quantizedFrame.encode(quantizedRect));
+	ASSERT(quantizedRect.IsContainedIn(decodedRect) && decodedRect.Width() - quantizedRect.Width() <= 2 * 1000.f / 65535);
+	std::vector<uint64_t> sortedIds = { 0, 1, 2, 300, 70000, UINT64_MAX }, decodedIds;
+	std::vector<uint8_t> encodedIds;
+	ASSERT(EncodeSortedIds(sortedIds.data(), sortedIds.size(), encodedIds));
+	ASSERT(DecodeSortedIds(encodedIds.data(), encodedIds.size(), decodedIds) && decodedIds == sortedIds);
+	std::swap(sortedIds[1], sortedIds[2]);
+	ASSERT(!EncodeSortedIds(sortedIds.data(), sortedIds.size(), encodedIds));
+	DCompactRectIndex compactIndex;
+	ASSERT(compactIndex.Build(rectIndex) && compactIndex.size() == rectIndex.size());
+	for (const auto&eachArea : indexAreas)
+	{
+		std::vector<uint64_t> exactIds;
+		rectIndex.Search(eachArea, exactIds);
+		std::vector<uint64_t> compactIds;
+		bool containsExact = true;
+		compactIndex.Visit(eachArea, [&](uint32_t id, const DRect&rect) {
+			DRect exact(indexRects[id]);
+			exact.Normalize();
+			containsExact = containsExact && exact.IsContainedIn(rect);
+			compactIds.push_back(id);
+			return true;
+		});
+		std::sort(exactIds.begin(), exactIds.end());
+		std::sort(compactIds.begin(), compactIds.end());
+		ASSERT(containsExact && std::includes(compactIds.begin(), compactIds.end(), exactIds.begin(), exactIds.end()));
+	}
+
+	// Diff tests: the sorted merge and the hash join report the same changes
+	IDRArray beforeRects(indexRects.begin(), indexRects.begin() + 50), afterRects(beforeRects);
+	afterRects.erase(afterRects.begin() + 3);				// removes id 3
+	afterRects.push_back(IDRect(DRect(1, 2, 3, 4), 1000));	// adds id 1000
+	afterRects[4].Move(1, 0);								// moves id 5
+	afterRects[6].right += 1;								// resizes id 7
+	afterRects[8].left -= 1;								// moves and resizes id 9
+	afterRects[10].bottom += 1e-4f;							// under epsilon for id 11
+	DRectDiff mergedDiff, hashedDiff;
+	DiffRects(beforeRects, afterRects, mergedDiff, 0.01f);
+	std::reverse(afterRects.begin(), afterRects.end());
+	DiffRects(beforeRects, afterRects, hashedDiff, 0.01f);
+	std::sort(hashedDiff.moved.begin(), hashedDiff.moved.end());
+	std::sort(hashedDiff.resized.begin(), hashedDiff.resized.end());
+	for (const DRectDiff*eachDiff : { &mergedDiff, &hashedDiff })
+	{
+		ASSERT(eachDiff->added == std::vector<uint64_t>{ 1000 } && eachDiff->removed == std::vector<uint64_t>{ 3 });
+		ASSERT((eachDiff->moved == std::vector<uint64_t>{ 5, 9 }) && (eachDiff->resized == std::vector<uint64_t>{ 7, 9 }));
+	}
+	DiffRects(beforeRects, afterRects, hashedDiff);
+	ASSERT(hashedDiff.resized.size() == 3);
+	DiffRects(beforeRects, beforeRects, mergedDiff);
+	ASSERT(mergedDiff.isEmpty());
+
+	// Ray cast tests: the first hit is the smallest DRay::Intersects entry,
+	// ties going to the first item in the index
+	std::vector<DRay> testRays;
+	for (int i = 0; i < 40; i++)
+	{
+		testRays.push_back(DRay(DPoint(-20.f, i * 13.f), DPoint(1.f, (float)(i % 5) - 2)));
+		testRays.push_back(DRay(DPoint(i * 13.f, 600.f), DPoint((float)(i % 3) - 1, -1.f)));
+	}
+	testRays.push_back(DRay::fromPoints(DPoint(150, 150), DPoint(160, 150))); // may start inside
+	DRectIndexView rayView = rectIndex.view();
+	std::vector<DRayHit> batchHits(testRays.size());
+	RayCastFirst(rayView, testRays.data(), testRays.size(), batchHits.data(), 1000.f);
+	for (size_t r = 0; r < testRays.size(); r++)
+	{
+		DRayHit expected;
+		for (size_t i = 0; i < rayView.itemCount; i++)
+		{
+			float t;
+			if (testRays[r].Intersects(rayView.items[i], t, 1000.f) && t < expected.t)
+			{
+				expected.t = t;
+				expected.id = rayView.items[i].id;
+			}
+		}
+		DRayHit hit = RayCastFirst(rayView, testRays[r], 1000.f);
+		ASSERT(hit.t == expected.t && (!hit.isHit() || hit.id == expected.id));
+		ASSERT(batchHits[r].t == hit.t && batchHits[r].id == hit.id);
+	}
+	ASSERT(!RayCastFirst(rayView, DRay::fromPoints(DPoint(-20, -20), DPoint(-10, -20)), 1.f).isHit());
+
+	// Hull tests: interior and collinear points drop out, and the calipers find
+	// the rotated square rather than its axis-aligned bounds
+	DPointArray hullInput = { DPoint(0, -10), DPoint(1, 1), DPoint(10, 0), DPoint(5, -5), DPoint(-2, 3),
+		DPoint(0, 10), DPoint(-10, 0), DPoint(10, 0) };
+	DPointArray hull;
+	ConvexHull(hullInput, hull);
+	ASSERT(hull.size() == 4 && DPolygon(hull).area() == 200);
+	DOrientedRect minArea = MinAreaRect(hull);
+	ASSERT(fabsf(minArea.area() - 200) < 0.01f && fabsf(minArea.center.x) < 1e-4f && fabsf(minArea.center.y) < 1e-4f);
+	DRect minAreaBounds = minArea.bounds();
+	ASSERT(fabsf(minAreaBounds.Width() - 20) < 0.01f && fabsf(minAreaBounds.Height() - 20) < 0.01f);
+	DPointArray slabPoints = { DPoint(0, 0), DPoint(30, 0), DPoint(30, 10), DPoint(0, 10), DPoint(15, 5) };
+	ConvexHull(slabPoints, hull);
+	DOrientedRect minWidth = MinWidthRect(hull);
+	ASSERT(hull.size() == 4 && fabsf((std::min)(minWidth.size.width, minWidth.size.height) - 10) < 1e-4f);
+
+#ifdef DKGEOMETRY_COROUTINES
+	// Async query tests: chunks replay Visit in order, cancelling stops early,
+	// and the incremental join yields every pair once
+	std::vector<uint64_t> visitOrder, chunkOrder;
+	rectIndex.view().Visit(DRect(0, 0, 300, 300), [&](const IDRect&item) { visitOrder.push_back(item.id); return true; });
+	for (const auto&eachChunk : SearchChunks(rectIndex.view(), DRect(0, 0, 300, 300), 7))
+	{
+		ASSERT(eachChunk.size() > 0 && eachChunk.size() <= 7);
+		for (const auto&eachItem : eachChunk) chunkOrder.push_back(eachItem.id);
+	}
+	ASSERT(chunkOrder == visitOrder);
+	DCancellation cancelSearch;
+	size_t chunksSeen = 0;
+	for (const auto&eachChunk : SearchChunks(rectIndex.view(), DRect(0, 0, 300, 300), 7, &cancelSearch))
+	{
+		chunksSeen += eachChunk.size();
+		cancelSearch.cancel();
+	}
+	ASSERT(chunksSeen == 7);
+	DJoinPairArray allPairs;
+	SpatialJoin(joinLeft, joinRight, allPairs);
+	DRectIndex joinRightIndex(joinRight);
+	std::vector<std::pair<uint64_t, uint64_t>> chunkPairs, wholePairs;
+	for (const auto&eachChunk : SpatialJoinChunks(joinLeft, joinRightIndex, 16))
+		for (const auto&eachPair : eachChunk) chunkPairs.push_back(std::make_pair(eachPair.leftId, eachPair.rightId));
+	for (const auto&eachPair : allPairs) wholePairs.push_back(std::make_pair(eachPair.leftId, eachPair.rightId));
+	std::sort(chunkPairs.begin(), chunkPairs.end());
+	std::sort(wholePairs.begin(), wholePairs.end());
+	ASSERT(chunkPairs == wholePairs);
+#endif
+
+	// Rasterizer tests: pixel centers decide, left/top inclusive and
+	// right/bottom exclusive, so rects sharing an edge never double count
+	DRectArray rasterRects = { DRect(0, 0, 5, 5), DRect(5, 0, 10, 5), DRect(2.4f, 2.4f, 2.6f, 2.6f),
+		DRect(3.5f, 6, 4.5f, 7), DRect(8, 8, 8, 9), DRect(9, 6, 7.5f, 7.75f) };
+	DCoverageMask countMask, bitMask;
+	DScanlineSpans rasterSpans;
+	RasterizeRects(rasterRects, DRect(0, 0, 10, 10), 10, 10, DCoverageCounts, countMask);
+	RasterizeRects(rasterRects, DRect(0, 0, 10, 10), 10, 10, DCoverageBits, bitMask);
+	RasterizeSpans(rasterRects, DRect(0, 0, 10, 10), 10, 10, rasterSpans);
+	for (uint32_t y = 0; y < 10; y++)
+	{
+		uint32_t spanPixels = 0;
+		for (size_t i = 0; i < rasterSpans.spanCount(y); i++) spanPixels += rasterSpans.rowSpans(y)[i].end - rasterSpans.rowSpans(y)[i].begin;
+		uint32_t rowPixels = 0;
+		for (uint32_t x = 0; x < 10; x++)
+		{
+			uint8_t expected = 0;
+			for (auto eachRect : rasterRects)
+			{
+				eachRect.Normalize();
+				if (eachRect.left <= x + 0.5f && x + 0.5f < eachRect.right && eachRect.top <= y + 0.5f && y + 0.5f < eachRect.bottom) expected++;
+			}
+			ASSERT(countMask.at(x, y) == expected && bitMask.at(x, y) == (expected ? 1 : 0));
+			rowPixels += expected ? 1 : 0;
+		}
+		ASSERT(spanPixels == rowPixels);
+	}
+	ASSERT(countMask.at(2, 2) == 2 && countMask.at(3, 6) == 1 && countMask.at(4, 6) == 0 && countMask.at(8, 8) == 0);
+	ASSERT(rasterSpans.spanCount(0) == 1 && rasterSpans.rowSpans(0)[0].begin == 0 && rasterSpans.rowSpans(0)[0].end == 10);
+	DRect rasterClip(0, 0, 1, 1);
+	RasterizeRects(rasterRects, DRect(0, 0, 10, 10), 10, 10, DCoverageCounts, countMask, &rasterClip);
+	ASSERT(countMask.at(0, 0) == 1 && countMask.at(1, 0) == 0 && countMask.at(2, 2) == 0);
+
 	return false;
 }
 
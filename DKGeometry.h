@@ -30,11 +30,16 @@ SOFTWARE.
 #include <limits>
 #include <algorithm>
 #include <iterator>
+#include <memory_resource>
 
 #define PI_F			3.14159265359f
 #define PI_2_F			1.57079632679f
 #define TORADIANS_F		1.74532925199e-002f
 
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define DKGEOMETRY_SSE2 1
+#endif
+
 namespace DKGeometry
 {
 	class DRect;
@@ -54,14 +59,23 @@ namespace DKGeometry
 		DRange(const DWRITE_TEXT_RANGE&range) : start(range.startPosition), length(range.length) {}
 		inline operator DWRITE_TEXT_RANGE() { return{ start, length }; }
 
+		// last position in the range; undefined for empty ranges, see limit()
 		inline uint32_t end() const { return start + length - 1; } 
+		// one past the last position, safe for empty ranges; saturates at
+		// UINT32_MAX, so a range ending past it stops at UINT32_MAX - 1
+		inline uint32_t limit() const { return start + (std::min)(length, UINT32_MAX - start); }
+		inline bool isEmpty() const { return length == 0; }
 		inline bool isInvalid() const { return (start == DRANGE_INVALID); }
 
+		inline bool operator==(const DRange&range) const { return start == range.start && length == range.length; }
+		inline bool operator!=(const DRange&range) const { return !(*this == range); }
+
 		inline DRange intersect(const DRange&range) const {
+			if (length == 0 || range.length == 0) return DRange(DRANGE_INVALID, 0);
 			uint32_t newstart = max(start, range.start);
-			uint32_t newend = min(end(), range.end());
-			if (newstart <= newend)
-				return DRange(newstart, 1 + newend - newstart);
+			uint32_t newlimit = min(limit(), range.limit());
+			if (newstart < newlimit)
+				return DRange(newstart, newlimit - newstart);
 			return DRange(DRANGE_INVALID, 0);
 		}
 		
@@ -70,10 +84,22 @@ namespace DKGeometry
 	inline DRange ZeroRange() { return { 0, 0 }; }
 
 	typedef std::vector<DRect>	DRectArray;
+	typedef std::vector<DPoint>	DPointArray;
 
 	typedef std::function<DKGeometry::DRectArray()> GetRectsFunc;
 
+	// the same containers over a std::pmr::memory_resource, e.g. a DFrameArena
+	namespace pmr
+	{
+		typedef std::pmr::vector<DRect>		DRectArray;
+		typedef std::pmr::vector<DPoint>	DPointArray;
+
+		typedef std::function<DKGeometry::pmr::DRectArray()> GetRectsFunc;
+	}
+
 	DRect GetCombinedRect(const DRectArray&rectarray);
+	DRect GetCombinedRect(const pmr::DRectArray&rectarray);
+	DRect GetCombinedRect(const DRect*rects, size_t count);
 
 	inline bool closeToZero(float compare) 
 	{
@@ -382,14 +408,18 @@ namespace DKGeometry
 	}
 
 
+	/// <summary>
+	/// Line in slope-intercept form, y = m * x + b, bounded by s1 and s2 along
+	/// its major axis (x when |m| > 1, y otherwise). Vertical lines store the
+	/// x position in b. See DRay for casting against rects.</summary>
 	class MLine {
-
+	public:
 		float s1;
 		float s2;
 		float m;
 		float b;
 		
-		inline DPoint startPoint() {
+		inline DPoint startPoint() const {
 			if ((m > 1) || (m < -1))
 			{
 				return { s1, (s1 * m) + b};
@@ -399,7 +429,7 @@ namespace DKGeometry
 			}
 		}
 
-		inline DPoint endPoint() {
+		inline DPoint endPoint() const {
 			if ((m > 1) || (m < -1))
 			{
 				return{ s2, (s2 * m) + b };
@@ -458,11 +488,22 @@ namespace DKGeometry
 
 	};
 
+	// DPredicateRobust answers segment tests exactly (see DKRobust.h); lines
+	// with infinite ends always take the fast slope-based path
+	enum DPredicateMode
+	{
+		DPredicateFast,
+		DPredicateRobust
+	};
+
 	class DLine
 	{
 	private:
 		float m;
 		float b;
+
+		bool containsPointRobust(const DPoint&point) const;
+		bool crossesRobust(const DLine&line) const;
 	public:
 		DPoint start;
 		DPoint end;
@@ -540,8 +581,19 @@ namespace DKGeometry
 				(y >= end.y && y <= start.y);
 		}
 
-		inline bool containsPoint(const DPoint&point) const
+		inline bool isFinite() const {
+			return std::isfinite(start.x) && std::isfinite(start.y) &&
+				std::isfinite(end.x) && std::isfinite(end.y);
+		}
+
+		/// <summary>
+		/// Returns true if the point lies on the line. The fast mode compares
+		/// against the slope with an absolute epsilon; the robust mode is an
+		/// exact test against the closed segment.</summary>
+		inline bool containsPoint(const DPoint&point, DPredicateMode mode = DPredicateFast) const
 		{
+			if (mode == DPredicateRobust && isFinite()) return containsPointRobust(point);
+
 			float b1;
 			float m1 = slope(b1);
 
@@ -556,7 +608,13 @@ namespace DKGeometry
 		}
 
 
-		inline bool crosses(const DLine&line) const {
+		/// <summary>
+		/// Returns true if the lines meet. The fast mode intersects the two
+		/// slope forms and never reports parallel lines; the robust mode is an
+		/// exact test of the closed segments sharing a point, collinear
+		/// overlaps included.</summary>
+		inline bool crosses(const DLine&line, DPredicateMode mode = DPredicateFast) const {
+			if (mode == DPredicateRobust && isFinite() && line.isFinite()) return crossesRobust(line);
 
 			float b1;
 			float m1 = slope(b1);
@@ -594,6 +652,35 @@ namespace DKGeometry
 
 	};
 
+	/// <summary>
+	/// Ray from origin along direction; points on it are origin + t * direction
+	/// for t >= 0. With fromPoints the segment ends at t = 1.</summary>
+	class DRay
+	{
+	public:
+		DPoint origin;
+		DPoint direction;
+
+		inline DRay() : origin(0, 0), direction(1, 0) {}
+		inline DRay(const DPoint&origin, const DPoint&direction) : origin(origin), direction(direction) {}
+
+		static inline DRay fromPoints(const DPoint&start, const DPoint&toward) {
+			return DRay(start, toward - start);
+		}
+
+		inline DPoint pointAt(float t) const { return origin + direction * t; }
+
+		/// <summary>
+		/// Slab test against the rect, edges included.</summary>
+		/// <param name="tNear">receives the entry parameter, 0 when origin is inside</param>
+		/// <param name="tMax">hits past this parameter are ignored</param>
+		/// <returns>
+		/// true if the ray meets the rect for some t in [0, tMax]
+		/// </returns>
+		bool Intersects(const DRect&rect, float&tNear, float tMax = DKInfinity) const;
+		inline bool Intersects(const DRect&rect) const { float tNear; return Intersects(rect, tNear); }
+	};
+
 	class DRect
 	{
 	public:
@@ -811,6 +898,21 @@ namespace DKGeometry
 			return { topLeft(), topRight(), bottomLeft(), bottomRight() };
 		}
 
+		inline pmr::DPointArray getPoints(std::pmr::memory_resource*resource) const {
+			pmr::DPointArray result(resource);
+			result.reserve(4);
+			result.insert(result.end(), { topLeft(), topRight(), bottomLeft(), bottomRight() });
+			return result;
+		}
+
+		// fills points without allocating, in getPoints() order
+		inline void getPoints(DPoint points[4]) const {
+			points[0] = topLeft();
+			points[1] = topRight();
+			points[2] = bottomLeft();
+			points[3] = bottomRight();
+		}
+
 		inline std::vector<DPoint> getRotatedPoints(float radians, const DPoint&origin=DPoint(0,0)) const {
 			auto points = getPoints();
 			decltype(points) result;
@@ -823,12 +925,26 @@ namespace DKGeometry
 			return result;
 		}
 
+		inline pmr::DPointArray getRotatedPoints(float radians, const DPoint&origin, std::pmr::memory_resource*resource) const {
+			DPoint points[4];
+			getPoints(points);
+			pmr::DPointArray result(resource);
+			result.reserve(4);
+			for (auto&eachPoint : points)
+			{
+				result.push_back(eachPoint.rotated(radians, origin));
+			}
+			return result;
+		}
+
 
 		inline DRect getRotatedBounds(float angle, DPoint origin=DPoint(0, 0)) const
 		{
 			// there is a more efficient way to do this, but this is a simple method that works
 			DRect bounds(DKInfinity, DKInfinity, DKNegInfinity, DKNegInfinity);
-			for (auto&eachPoint : getPoints())
+			DPoint points[4];
+			getPoints(points);
+			for (auto&eachPoint : points)
 			{
 				auto rotatedPoint = eachPoint.getRotatedPoint(angle, origin);
 				if (rotatedPoint.x < bounds.left) bounds.left = rotatedPoint.x;
@@ -921,6 +1037,13 @@ namespace DKGeometry
 			return { topLine(), leftLine(), bottomLine(), rightLine() };
 		}
 
+		inline std::pmr::vector<DLine> getLines(std::pmr::memory_resource*resource) const {
+			std::pmr::vector<DLine> result(resource);
+			result.reserve(4);
+			result.insert(result.end(), { topLine(), leftLine(), bottomLine(), rightLine() });
+			return result;
+		}
+
 		inline bool LineCrossesRect(const DLine&line) const {
 			return (line.crosses(topLine()) || line.crosses(leftLine()) ||
 				line.crosses(bottomLine()) || line.crosses(rightLine()));
@@ -953,6 +1076,11 @@ namespace DKGeometry
 
 	typedef std::vector<IDRect> IDRArray;
 
+	namespace pmr
+	{
+		typedef std::pmr::vector<IDRect>	IDRArray;
+	}
+
 	DRect ERROR_RECT();
 	DRect INFINITY_RECT();
 
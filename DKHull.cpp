@@ -0,0 +1,224 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKHull.h"
+
+#include <math.h>
+
+using namespace DKGeometry;
+
+
+void DKGeometry::DOrientedRect::getPoints(DPoint points[4]) const
+{
+	float c = cosf(angle);
+	float s = sinf(angle);
+	DPoint u(c * size.width / 2.f, s * size.width / 2.f);
+	DPoint v(-s * size.height / 2.f, c * size.height / 2.f);
+	points[0] = center - u - v;
+	points[1] = center + u - v;
+	points[2] = center + u + v;
+	points[3] = center - u + v;
+}
+
+DRect DKGeometry::DOrientedRect::bounds() const
+{
+	DPoint points[4];
+	getPoints(points);
+	DRect result(points[0], points[0]);
+	for (int i = 1; i < 4; i++)
+	{
+		result.CombineWith(DRect(points[i], points[i]));
+	}
+	return result;
+}
+
+
+namespace
+{
+	const size_t HullSortGrain = 65536;
+
+	inline bool lexLess(const DPoint&a, const DPoint&b)
+	{
+		return a.x < b.x || (a.x == b.x && a.y < b.y);
+	}
+
+	inline double cross(const DPoint&o, const DPoint&a, const DPoint&b)
+	{
+		return ((double)a.x - o.x) * ((double)b.y - o.y) - ((double)a.y - o.y) * ((double)b.x - o.x);
+	}
+
+	void sortPoints(DPointArray&points, DExecutor&executor)
+	{
+		size_t count = points.size();
+		if (count <= HullSortGrain)
+		{
+			std::sort(points.begin(), points.end(), lexLess);
+			return;
+		}
+
+		executor.parallelFor(count, HullSortGrain, [&](size_t begin, size_t end) {
+			std::sort(points.begin() + begin, points.begin() + end, lexLess);
+		});
+		for (size_t width = HullSortGrain; width < count; width *= 2)
+		{
+			size_t pairs = (count + 2 * width - 1) / (2 * width);
+			executor.parallelFor(pairs, 1, [&](size_t begin, size_t end) {
+				for (size_t pair = begin; pair < end; pair++)
+				{
+					size_t first = pair * 2 * width;
+					size_t middle = (std::min)(first + width, count);
+					size_t last = (std::min)(first + 2 * width, count);
+					std::inplace_merge(points.begin() + first, points.begin() + middle, points.begin() + last, lexLess);
+				}
+			});
+		}
+	}
+}
+
+void DKGeometry::ConvexHull(const DPoint * points, size_t count, DPointArray & hull, DExecutor & executor)
+{
+	hull.clear();
+	DPointArray sorted;
+	sorted.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		// NaN coordinates would break the ordering
+		if (points[i].x == points[i].x && points[i].y == points[i].y) sorted.push_back(points[i]);
+	}
+	sortPoints(sorted, executor);
+	sorted.erase(std::unique(sorted.begin(), sorted.end(), [](const DPoint&a, const DPoint&b) {
+		return a.x == b.x && a.y == b.y;
+	}), sorted.end());
+
+	size_t n = sorted.size();
+	if (n < 3)
+	{
+		hull = sorted;
+		return;
+	}
+
+	// lower chain left to right, then upper chain back, keeping right turns only
+	hull.resize(2 * n);
+	size_t k = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		while (k >= 2 && cross(hull[k - 2], hull[k - 1], sorted[i]) <= 0) k--;
+		hull[k++] = sorted[i];
+	}
+	for (size_t i = n - 1, lower = k + 1; i-- > 0; )
+	{
+		while (k >= lower && cross(hull[k - 2], hull[k - 1], sorted[i]) <= 0) k--;
+		hull[k++] = sorted[i];
+	}
+	hull.resize(k - 1);
+}
+
+void DKGeometry::ConvexHull(const DPointArray & points, DPointArray & hull, DExecutor & executor)
+{
+	ConvexHull(points.data(), points.size(), hull, executor);
+}
+
+
+namespace
+{
+	// calls visit(edge, uMin, uMax, vExtreme) for each hull edge, where u runs
+	// along the edge and v across it, both measured from the edge's start
+	template <class Visit>
+	void rotatingCalipers(const DPointArray&hull, Visit visit)
+	{
+		size_t n = hull.size();
+		size_t right = 0, far = 0, left = 0;
+		auto at = [&](size_t i) -> const DPoint& { return hull[i % n]; };
+
+		for (size_t edge = 0; edge < n; edge++)
+		{
+			const DPoint&p = hull[edge];
+			const DPoint&q = at(edge + 1);
+			double ex = (double)q.x - p.x, ey = (double)q.y - p.y;
+			double length = sqrt(ex * ex + ey * ey);
+			if (length == 0) continue;
+			double ux = ex / length, uy = ey / length;
+
+			auto alongU = [&](size_t i) { return ((double)at(i).x - p.x) * ux + ((double)at(i).y - p.y) * uy; };
+			auto acrossV = [&](size_t i) { return ((double)at(i).y - p.y) * ux - ((double)at(i).x - p.x) * uy; };
+
+			// the three calipers only ever move forward, at most once around
+			if (edge == 0) right = far = left = 0;
+			if (right < edge) right = edge;
+			for (size_t steps = 0; steps < n && alongU(right + 1) >= alongU(right); steps++) right++;
+			if (far < right) far = right;
+			for (size_t steps = 0; steps < n && fabs(acrossV(far + 1)) >= fabs(acrossV(far)); steps++) far++;
+			if (left < far) left = far;
+			for (size_t steps = 0; steps < n && alongU(left + 1) <= alongU(left); steps++) left++;
+
+			visit(edge, ux, uy, alongU(left), alongU(right), acrossV(far));
+		}
+	}
+
+	DOrientedRect makeRect(const DPoint&origin, double ux, double uy, double uMin, double uMax, double vExtreme)
+	{
+		// v is (-uy, ux) rotated from u; acrossV measures along it
+		double uMid = (uMin + uMax) / 2;
+		double vMid = vExtreme / 2;
+		DOrientedRect result;
+		result.center = DPoint((float)(origin.x + ux * uMid - uy * vMid), (float)(origin.y + uy * uMid + ux * vMid));
+		result.size = DSize((float)(uMax - uMin), (float)fabs(vExtreme));
+		result.angle = (float)atan2(uy, ux);
+		return result;
+	}
+
+	template <class Score>
+	DOrientedRect bestRect(const DPointArray&hull, Score score)
+	{
+		DOrientedRect best;
+		if (hull.empty()) return best;
+		best.center = hull.front();
+		if (hull.size() == 1) return best;
+
+		double bestScore = INFINITY;
+		rotatingCalipers(hull, [&](size_t edge, double ux, double uy, double uMin, double uMax, double vExtreme) {
+			double value = score(uMax - uMin, fabs(vExtreme));
+			if (value < bestScore)
+			{
+				bestScore = value;
+				best = makeRect(hull[edge], ux, uy, uMin, uMax, vExtreme);
+			}
+		});
+		return best;
+	}
+}
+
+DOrientedRect DKGeometry::MinAreaRect(const DPointArray & hull)
+{
+	return bestRect(hull, [](double length, double width) { return length * width; });
+}
+
+DOrientedRect DKGeometry::MinWidthRect(const DPointArray & hull)
+{
+	return bestRect(hull, [](double, double width) { return width; });
+}
@@ -0,0 +1,62 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKThreadPool.h"
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Rect of the given size centered on center and rotated by angle radians,
+	/// the same way DPoint::rotated turns points.</summary>
+	struct DOrientedRect
+	{
+		DPoint center;
+		DSize size;
+		float angle = 0;
+
+		inline float area() const { return size.width * size.height; }
+
+		// corners in the order top-left, top-right, bottom-right, bottom-left before rotation
+		void getPoints(DPoint points[4]) const;
+		DRect bounds() const;
+	};
+
+	/// <summary>
+	/// Convex hull by Andrew's monotone chain. Points are sorted by x then y,
+	/// in parallel chunks merged pairwise when there are many; duplicate and
+	/// collinear points are dropped. The hull is clockwise in y-down
+	/// coordinates, so DPolygon(hull).area() is positive.</summary>
+	void ConvexHull(const DPoint*points, size_t count, DPointArray&hull, DExecutor&executor = DefaultExecutor());
+	void ConvexHull(const DPointArray&points, DPointArray&hull, DExecutor&executor = DefaultExecutor());
+
+	/// <summary>
+	/// Smallest-area and smallest-width enclosing rects of a convex hull, as
+	/// returned by ConvexHull, using rotating calipers in O(n). One side of
+	/// the result is always flush with a hull edge.</summary>
+	DOrientedRect MinAreaRect(const DPointArray&hull);
+	DOrientedRect MinWidthRect(const DPointArray&hull);
+
+}
@@ -0,0 +1,216 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKLabelPlacer.h"
+
+#include <chrono>
+#include <math.h>
+#include <numeric>
+
+using namespace DKGeometry;
+
+
+// positive area overlap; shared edges are allowed between labels
+static inline bool overlaps(const DRect&a, const DRect&b)
+{
+	return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+}
+
+void DKGeometry::DLabelPlacer::addObstacle(const DRect & rect)
+{
+	DRect normalized(rect);
+	normalized.Normalize();
+	obstacles.push_back(normalized);
+}
+
+void DKGeometry::DLabelPlacer::clearObstacles()
+{
+	obstacles.clear();
+}
+
+void DKGeometry::DLabelPlacer::resetGrid(float size)
+{
+	cellSize = size > 0 ? size : 1.f;
+	boxes.clear();
+	grid.clear();
+	largeBoxes.clear();
+	occupied = { 1, 1, 0, 0 };
+	for (const auto&eachObstacle : obstacles) addToGrid(eachObstacle);
+}
+
+void DKGeometry::DLabelPlacer::addToGrid(const DRect & rect)
+{
+	uint32_t index = (uint32_t)boxes.size();
+	boxes.push_back(rect);
+
+	CellRange cells = cellsOf(rect);
+	if ((int64_t)cells.x1 - cells.x0 >= LargeCells || (int64_t)cells.y1 - cells.y0 >= LargeCells)
+	{
+		largeBoxes.push_back(index);
+		return;
+	}
+
+	for (int y = cells.y0; y <= cells.y1; y++)
+		for (int x = cells.x0; x <= cells.x1; x++)
+			grid[key(x, y)].push_back(index);
+
+	if (occupied.x0 > occupied.x1) {
+		occupied = cells;
+	}
+	else {
+		occupied.x0 = (std::min)(occupied.x0, cells.x0);
+		occupied.y0 = (std::min)(occupied.y0, cells.y0);
+		occupied.x1 = (std::max)(occupied.x1, cells.x1);
+		occupied.y1 = (std::max)(occupied.y1, cells.y1);
+	}
+}
+
+const DRect * DKGeometry::DLabelPlacer::findBlocker(const DRect & rect)
+{
+	for (uint32_t eachIndex : largeBoxes)
+	{
+		if (overlaps(rect, boxes[eachIndex])) return &boxes[eachIndex];
+	}
+
+	// only the cells that can hold entries, however large the rect
+	CellRange cells = cellsOf(rect);
+	int x0 = (std::max)(cells.x0, occupied.x0), x1 = (std::min)(cells.x1, occupied.x1);
+	int y0 = (std::max)(cells.y0, occupied.y0), y1 = (std::min)(cells.y1, occupied.y1);
+	if (x0 <= x1 && y0 <= y1 && (double)(x1 - x0 + 1) * (y1 - y0 + 1) > (double)boxes.size())
+	{
+		// a rect over more cells than there are boxes is cheaper to test directly
+		for (const auto&eachBox : boxes)
+		{
+			if (overlaps(rect, eachBox)) return &eachBox;
+		}
+		return nullptr;
+	}
+	for (int y = y0; y <= y1; y++)
+	{
+		for (int x = x0; x <= x1; x++)
+		{
+			auto cell = grid.find(key(x, y));
+			if (cell == grid.end()) continue;
+			for (uint32_t eachIndex : cell->second)
+			{
+				if (overlaps(rect, boxes[eachIndex])) return &boxes[eachIndex];
+			}
+		}
+	}
+	return nullptr;
+}
+
+bool DKGeometry::DLabelPlacer::nudge(DRect & rect, const DRect & original)
+{
+	for (int step = 0; step < options.nudgeSteps; step++)
+	{
+		const DRect*blocker = findBlocker(rect);
+		if (!blocker) return true;
+
+		// an edge crossing into the blocker means leaving through the far side
+		RectComparision side = rect.compareToRect(*blocker);
+		float dx = side.left ? blocker->right - rect.left : blocker->left - rect.right;
+		float dy = side.top ? blocker->bottom - rect.top : blocker->top - rect.bottom;
+
+		DRect byX(rect), byY(rect);
+		byX.Move(dx, 0);
+		byY.Move(0, dy);
+		bool xFits = fabsf(byX.left - original.left) <= options.maxNudge;
+		bool yFits = fabsf(byY.top - original.top) <= options.maxNudge;
+		if (!xFits && !yFits) return false;
+
+		if (xFits && (!yFits || fabsf(dx) <= fabsf(dy))) rect = byX;
+		else rect = byY;
+	}
+	return findBlocker(rect) == nullptr;
+}
+
+DLabelResult DKGeometry::DLabelPlacer::Place(const DLabelCandidateArray & candidates, IDRArray & placed)
+{
+	typedef std::chrono::steady_clock Clock;
+	Clock::time_point started = Clock::now();
+
+	DLabelResult result;
+
+	std::vector<uint32_t> order(candidates.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&candidates](uint32_t a, uint32_t b) {
+		return candidates[a].priority > candidates[b].priority;
+	});
+
+	// cells about twice the typical label keep per-label cell counts small
+	double totalSize = 0;
+	for (const auto&eachCandidate : candidates)
+	{
+		totalSize += fabsf(eachCandidate.rect.Width()) + fabsf(eachCandidate.rect.Height());
+	}
+	resetGrid(candidates.empty() ? 1.f : (float)(totalSize / candidates.size()));
+	boxes.reserve(obstacles.size() + candidates.size());
+
+	std::unordered_set<uint64_t> placedIds;
+	std::unordered_set<uint64_t> droppedIds;
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		if (options.timeBudget > 0 && i && (i & 255) == 0 &&
+			std::chrono::duration<double, std::milli>(Clock::now() - started).count() > options.timeBudget)
+		{
+			result.timedOut = true;
+			break;
+		}
+
+		const IDRect&candidate = candidates[order[i]].rect;
+		if (placedIds.count(candidate.id)) continue;
+
+		DRect rect(candidate);
+		rect.Normalize();
+		bool moved = false;
+		if (findBlocker(rect))
+		{
+			DRect original(rect);
+			if (options.maxNudge <= 0 || !nudge(rect, original))
+			{
+				droppedIds.insert(candidate.id);
+				continue;
+			}
+			moved = true;
+		}
+
+		addToGrid(rect);
+		placedIds.insert(candidate.id);
+		placed.push_back(IDRect(rect, candidate.id));
+		result.placed++;
+		if (moved) result.nudged++;
+	}
+
+	// an id counts as dropped only if no alternative of it was placed
+	for (uint64_t eachId : droppedIds)
+	{
+		if (!placedIds.count(eachId)) result.dropped++;
+	}
+	return result;
+}
@@ -0,0 +1,130 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKGeometry.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace DKGeometry
+{
+	struct DLabelCandidate
+	{
+		IDRect rect;
+		float priority;		// higher is placed first
+	};
+
+	typedef std::vector<DLabelCandidate> DLabelCandidateArray;
+
+	struct DLabelOptions
+	{
+		// largest distance a label may be pushed on either axis, 0 disables nudging
+		float maxNudge = 0.f;
+		// pushes tried per candidate before it is dropped
+		int nudgeSteps = 4;
+		// milliseconds before Place returns what it has, 0 for no limit
+		double timeBudget = 0;
+	};
+
+	struct DLabelResult
+	{
+		size_t placed = 0;
+		size_t nudged = 0;
+		// label ids none of whose candidates could be placed
+		size_t dropped = 0;
+		bool timedOut = false;
+	};
+
+	/// <summary>
+	/// Greedy label placement. Candidates are taken in priority order and a
+	/// candidate is kept if it overlaps no placed label or obstacle; touching
+	/// edges do not count as overlap. Several candidates may share an id to
+	/// offer alternative positions, the first one that fits wins.
+	///
+	/// A blocked candidate can be nudged: compareToRect against the blocker
+	/// tells which of its edges lie inside it, and the label is pushed out
+	/// through the nearer of those sides. Placed labels live in a uniform
+	/// hash grid sized from the candidates, so each test only looks at its
+	/// neighbourhood; obstacles or labels spanning more than a few cells are
+	/// kept in a short list beside the grid and tested directly.
+	///
+	/// When the time budget runs out the labels placed so far are returned;
+	/// they are the highest priority ones.</summary>
+	class DLabelPlacer
+	{
+	public:
+		DLabelPlacer() {}
+		explicit DLabelPlacer(const DLabelOptions&options) : options(options) {}
+
+		inline void setOptions(const DLabelOptions&newOptions) { options = newOptions; }
+		inline const DLabelOptions& getOptions() const { return options; }
+
+		// areas labels must stay clear of, kept across Place calls
+		void addObstacle(const DRect&rect);
+		void clearObstacles();
+
+		// placed receives the kept labels with their final rects, in placement order
+		DLabelResult Place(const DLabelCandidateArray&candidates, IDRArray&placed);
+
+	private:
+		typedef int64_t CellKey;
+
+		// boxes covering more cells than this on an axis skip the grid
+		static const int LargeCells = 4;
+
+		struct CellRange
+		{
+			int x0, y0, x1, y1;
+		};
+
+		// clamped, so huge or infinite coordinates still give a valid range
+		inline int cellOf(float value) const {
+			double cell = floor(value / (double)cellSize);
+			if (!(cell > -(1 << 30))) return -(1 << 30);
+			if (cell > (1 << 30)) return 1 << 30;
+			return (int)cell;
+		}
+		inline CellRange cellsOf(const DRect&rect) const {
+			return { cellOf(rect.left), cellOf(rect.top), cellOf(rect.right), cellOf(rect.bottom) };
+		}
+		static inline CellKey key(int x, int y) { return ((CellKey)x << 32) ^ (uint32_t)y; }
+
+		void resetGrid(float size);
+		void addToGrid(const DRect&rect);
+		const DRect* findBlocker(const DRect&rect);
+		bool nudge(DRect&rect, const DRect&original);
+
+		DLabelOptions options;
+		DRectArray obstacles;
+
+		float cellSize = 1.f;
+		DRectArray boxes;	// obstacles followed by placed labels
+		std::unordered_map<CellKey, std::vector<uint32_t>> grid;
+		std::vector<uint32_t> largeBoxes;
+		CellRange occupied;	// cells holding any grid entry, empty when x0 > x1
+	};
+
+}
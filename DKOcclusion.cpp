@@ -0,0 +1,335 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKOcclusion.h"
+
+#include <float.h>
+#include <math.h>
+#include <unordered_map>
+
+using namespace DKGeometry;
+
+
+static inline bool overlaps(const DRect&a, const DRect&b)
+{
+	return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+}
+
+int DKGeometry::SubtractRect(const DRect & from, const DRect & cut, DRect pieces[4])
+{
+	if (!overlaps(from, cut))
+	{
+		if (from.area() <= 0) return 0;
+		pieces[0] = from;
+		return 1;
+	}
+
+	int count = 0;
+	float top = (std::max)(from.top, cut.top);
+	float bottom = (std::min)(from.bottom, cut.bottom);
+	if (cut.top > from.top) pieces[count++] = DRect(from.left, from.top, from.right, cut.top);
+	if (cut.bottom < from.bottom) pieces[count++] = DRect(from.left, cut.bottom, from.right, from.bottom);
+	if (cut.left > from.left) pieces[count++] = DRect(from.left, top, cut.left, bottom);
+	if (cut.right < from.right) pieces[count++] = DRect(cut.right, top, from.right, bottom);
+	return count;
+}
+
+
+namespace
+{
+	// disjoint opaque pieces bucketed in a uniform hash grid; a cell that
+	// becomes fully covered drops its list and stands in for its pieces.
+	// pieces spanning many cells are kept in a short list of their own
+	class Coverage
+	{
+	public:
+		// limits bounds every piece and query that can matter
+		Coverage(float size, const DRect&limits) : limits(limits)
+		{
+			// a power of two keeps cell edges exact in float
+			cellSize = size > 0 && size < DKInfinity ? exp2f(roundf(log2f(size))) : 1.f;
+		}
+
+		void add(const DRect&piece)
+		{
+			uint32_t index = (uint32_t)pieces.size();
+			pieces.push_back(piece);
+			seen.push_back(0);
+
+			// pieces over many cells, such as a background, stay out of the grid
+			CellRange range = cellsOf(piece);
+			if (range.x1 - range.x0 >= LargeCells || range.y1 - range.y0 >= LargeCells)
+			{
+				largePieces.push_back(index);
+				return;
+			}
+
+			forCells(range, [&](int x, int y) {
+				Cell&cell = cells[key(x, y)];
+				if (cell.full) return;
+				cell.items.push_back(index);
+
+				DRect bounds = cellRect(x, y);
+				cell.coveredArea += (double)((std::min)(piece.right, bounds.right) - (std::max)(piece.left, bounds.left)) *
+					((std::min)(piece.bottom, bounds.bottom) - (std::max)(piece.top, bounds.top));
+				if (cell.coveredArea >= (double)cellSize * cellSize * (1 - 1e-6) && isCovered(cell, bounds))
+				{
+					cell.full = true;
+					cell.items = std::vector<uint32_t>();
+				}
+			});
+		}
+
+		// true if every cell under rect is fully covered
+		bool allFull(const DRect&rect)
+		{
+			CellRange range = cellsOf(rect);
+			if (range.count() > cells.size()) return false;
+
+			bool full = true;
+			forCells(range, [&](int x, int y) {
+				if (!full) return;
+				auto cell = cells.find(key(x, y));
+				full = cell != cells.end() && cell->second.full;
+			});
+			return full;
+		}
+
+		// visit(piece) once for every piece whose cells meet rect, full cells
+		// visit their own rect; false stops
+		template <class Visit>
+		void query(const DRect&rect, Visit visit)
+		{
+			stamp++;
+			for (uint32_t eachIndex : largePieces)
+			{
+				const DRect&piece = pieces[eachIndex];
+				if (piece.left > rect.right || rect.left > piece.right || piece.top > rect.bottom || rect.top > piece.bottom) continue;
+				if (!visit(piece)) return;
+			}
+
+			bool keepGoing = true;
+			auto visitCell = [&](int x, int y, const Cell&cell) {
+				if (cell.full)
+				{
+					keepGoing = visit(cellRect(x, y));
+					return;
+				}
+				for (uint32_t eachIndex : cell.items)
+				{
+					if (seen[eachIndex] == stamp) continue;
+					seen[eachIndex] = stamp;
+					if (!(keepGoing = visit(pieces[eachIndex]))) return;
+				}
+			};
+
+			CellRange range = cellsOf(rect);
+			if (range.count() > cells.size())
+			{
+				// a rect over more cells than exist walks the cells instead
+				for (const auto&eachCell : cells)
+				{
+					int x = (int)(eachCell.first >> 32);
+					int y = (int)(uint32_t)eachCell.first;
+					if (x < range.x0 || x > range.x1 || y < range.y0 || y > range.y1) continue;
+					visitCell(x, y, eachCell.second);
+					if (!keepGoing) return;
+				}
+				return;
+			}
+
+			forCells(range, [&](int x, int y) {
+				if (!keepGoing) return;
+				auto cell = cells.find(key(x, y));
+				if (cell != cells.end()) visitCell(x, y, cell->second);
+			});
+		}
+
+	private:
+		// boxes covering more cells than this on an axis skip the grid
+		static const int64_t LargeCells = 8;
+
+		struct CellRange
+		{
+			int64_t x0, y0, x1, y1;
+
+			inline double count() const {
+				return x0 > x1 || y0 > y1 ? 0 : (double)(x1 - x0 + 1) * (y1 - y0 + 1);
+			}
+		};
+
+		struct Cell
+		{
+			std::vector<uint32_t> items;
+			double coveredArea = 0;
+			bool full = false;
+		};
+
+		static inline int64_t key(int x, int y) { return ((int64_t)x << 32) | (uint32_t)y; }
+
+		inline DRect cellRect(int x, int y) const {
+			return DRect(x * cellSize, y * cellSize, (x + 1) * cellSize, (y + 1) * cellSize);
+		}
+
+		// the area sum only hints; confirm by subtracting the pieces
+		bool isCovered(const Cell&cell, const DRect&bounds)
+		{
+			DRectArray remainder(1, bounds), next;
+			DRect split[4];
+			for (uint32_t eachIndex : cell.items)
+			{
+				next.clear();
+				for (const auto&eachPart : remainder)
+				{
+					int count = SubtractRect(eachPart, pieces[eachIndex], split);
+					next.insert(next.end(), split, split + count);
+				}
+				remainder.swap(next);
+				if (remainder.empty()) return true;
+			}
+			return false;
+		}
+
+		// clamped, so huge or infinite coordinates still give a valid cell
+		inline int64_t cellOf(float value) const {
+			double cell = floor(value / (double)cellSize);
+			if (!(cell > -(1 << 30))) return -(1 << 30);
+			if (cell > (1 << 30)) return 1 << 30;
+			return (int64_t)cell;
+		}
+
+		// cells under rect within the limits; empty when they do not meet
+		inline CellRange cellsOf(const DRect&rect) const {
+			CellRange range = { 0, 0, -1, -1 };
+			if (rect.right < limits.left || rect.left > limits.right || rect.bottom < limits.top || rect.top > limits.bottom)
+				return range;
+			range.x0 = cellOf((std::max)(rect.left, limits.left));
+			range.y0 = cellOf((std::max)(rect.top, limits.top));
+			range.x1 = cellOf((std::min)(rect.right, limits.right));
+			range.y1 = cellOf((std::min)(rect.bottom, limits.bottom));
+			return range;
+		}
+
+		template <class CellFunc>
+		void forCells(const CellRange&range, CellFunc func)
+		{
+			for (int64_t y = range.y0; y <= range.y1; y++)
+				for (int64_t x = range.x0; x <= range.x1; x++)
+					func((int)x, (int)y);
+		}
+
+		DRect limits;
+		float cellSize;
+		std::vector<uint32_t> largePieces;
+		DRectArray pieces;
+		std::vector<uint32_t> seen;
+		uint32_t stamp = 0;
+		std::unordered_map<int64_t, Cell> cells;
+	};
+}
+
+void DKGeometry::CullOccluded(const IDRArray & rects, const std::vector<uint8_t>& opaque, std::vector<uint64_t>& occluded, IDRArray * visibleParts)
+{
+	// cells follow the typical finite rect; huge ones are kept off the grid
+	double totalSize = 0;
+	size_t finiteCount = 0;
+	DRect limits;
+	for (size_t i = 0; i < rects.size(); i++)
+	{
+		DRect rect(rects[i]);
+		rect.Normalize();
+		if (i == 0) limits = rect;
+		else limits.CombineWith(rect);
+
+		double size = (double)rect.Width() + rect.Height();
+		if (size < (double)FLT_MAX)
+		{
+			totalSize += size;
+			finiteCount++;
+		}
+	}
+	Coverage coverage(finiteCount ? (float)(totalSize / finiteCount) : 1.f, limits);
+
+	// collected front to back, reversed at the end
+	std::vector<uint64_t> hidden;
+	IDRArray visible;
+	DRectArray remainder, next;
+	DRect split[4];
+
+	for (size_t i = rects.size(); i-- > 0;)
+	{
+		DRect rect(rects[i]);
+		rect.Normalize();
+
+		bool contained = coverage.allFull(rect);
+		if (!contained) coverage.query(rect, [&](const DRect&piece) {
+			contained = rect.IsContainedIn(piece);
+			return !contained;
+		});
+
+		remainder.clear();
+		if (!contained)
+		{
+			remainder.push_back(rect);
+			if (rect.area() > 0)
+			{
+				coverage.query(rect, [&](const DRect&piece) {
+					next.clear();
+					for (const auto&eachPart : remainder)
+					{
+						int count = SubtractRect(eachPart, piece, split);
+						next.insert(next.end(), split, split + count);
+					}
+					remainder.swap(next);
+					return !remainder.empty();
+				});
+			}
+		}
+
+		if (remainder.empty())
+		{
+			hidden.push_back(rects[i].id);
+			continue;
+		}
+
+		bool isOpaque = i < opaque.size() && opaque[i];
+		for (size_t part = remainder.size(); part-- > 0;)
+		{
+			if (isOpaque && remainder[part].area() > 0) coverage.add(remainder[part]);
+			if (visibleParts) visible.push_back(IDRect(remainder[part], rects[i].id));
+		}
+	}
+
+	occluded.insert(occluded.end(), hidden.rbegin(), hidden.rend());
+	if (visibleParts) visibleParts->insert(visibleParts->end(), visible.rbegin(), visible.rend());
+}
+
+void DKGeometry::CullOccluded(const IDRArray & rects, std::vector<uint64_t>& occluded, IDRArray * visibleParts)
+{
+	CullOccluded(rects, std::vector<uint8_t>(rects.size(), 1), occluded, visibleParts);
+}
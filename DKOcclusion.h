@@ -0,0 +1,55 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKGeometry.h"
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Region subtraction: writes from minus cut as up to four disjoint rects
+	/// (top band, bottom band, then left and right of the cut) and returns how
+	/// many. Both rects must be normalized; pieces of zero area are dropped.</summary>
+	int SubtractRect(const DRect&from, const DRect&cut, DRect pieces[4]);
+
+	/// <summary>
+	/// Occlusion pass over a back-to-front ordered list.
+	/// Rects are walked front to back while the area covered by opaque rects
+	/// is kept as disjoint pieces in a uniform grid; each rect is tested
+	/// against the pieces near it, first with IsContainedIn and then by
+	/// subtracting them. A rect is occluded when nothing of it remains.
+	/// Only the uncovered part of an opaque rect is added to the coverage,
+	/// which keeps the pieces disjoint and the pass close to linear.
+	///
+	/// occluded receives the hidden ids and visibleParts, when given, the
+	/// uncovered pieces of every other rect tagged with its id, both in the
+	/// original back-to-front order. opaque[i] marks rects[i] as opaque; the
+	/// overload without it treats every rect as opaque.</summary>
+	void CullOccluded(const IDRArray&rects, const std::vector<uint8_t>&opaque,
+		std::vector<uint64_t>&occluded, IDRArray*visibleParts = nullptr);
+	void CullOccluded(const IDRArray&rects,
+		std::vector<uint64_t>&occluded, IDRArray*visibleParts = nullptr);
+
+}
@@ -0,0 +1,106 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKParallel.h"
+
+using namespace DKGeometry;
+
+
+DRect DKGeometry::GetCombinedRect(const DRect * rects, size_t count, DExecutor & executor, size_t grain)
+{
+	if (count == 0) { return DRect(); }
+
+	DRect identity(DKInfinity, DKInfinity, DKNegInfinity, DKNegInfinity);
+	return ParallelReduce(executor, count, grain, identity,
+		[rects](size_t begin, size_t end) {
+			return GetCombinedRect(rects + begin, end - begin);
+		},
+		[](DRect combined, const DRect&partial) {
+			combined.CombineWith(partial);
+			return combined;
+		});
+}
+
+DRect DKGeometry::GetCombinedRect(const DRectArray & rectarray, DExecutor & executor, size_t grain)
+{
+	return GetCombinedRect(rectarray.data(), rectarray.size(), executor, grain);
+}
+
+void DKGeometry::IntersectsRect(const DRect * rects, size_t count, const DRect & rect, uint8_t * results, DExecutor & executor, size_t grain)
+{
+	DRect area(rect);
+	area.Normalize();
+
+	executor.parallelFor(count, grain, [=](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+		{
+			results[i] = rects[i].Intersects(area) ? 1 : 0;
+		}
+	});
+}
+
+void DKGeometry::ContainedInRect(const DRect * rects, size_t count, const DRect & rect, uint8_t * results, DExecutor & executor, size_t grain)
+{
+	executor.parallelFor(count, grain, [=](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+		{
+			results[i] = rects[i].IsContainedIn(rect) ? 1 : 0;
+		}
+	});
+}
+
+void DKGeometry::PointsInPolygon(const DPolygon & polygon, const DPoint * points, size_t count, uint8_t * results, DExecutor & executor, size_t grain)
+{
+	executor.parallelFor(count, grain, [&polygon, points, results](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+		{
+			results[i] = polygon.PointInPolygon(points[i]) ? 1 : 0;
+		}
+	});
+}
+
+void DKGeometry::MoveRects(DRect * rects, size_t count, float xAmount, float yAmount, DExecutor & executor, size_t grain)
+{
+	executor.parallelFor(count, grain, [=](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+		{
+			rects[i].Move(xAmount, yAmount);
+		}
+	});
+}
+
+void DKGeometry::GetRotatedBounds(const DRect * rects, size_t count, float angle, const DPoint & origin, DRect * results, DExecutor & executor, size_t grain)
+{
+	DPoint pivot(origin);
+	executor.parallelFor(count, grain, [=](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+		{
+			results[i] = rects[i].getRotatedBounds(angle, pivot);
+		}
+	});
+}
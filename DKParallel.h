@@ -0,0 +1,54 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKThreadPool.h"
+#include "DKPolygon.h"
+
+namespace DKGeometry
+{
+	// Batch operations on an executor. grain is the number of elements per
+	// chunk, 0 picks DExecutor::DefaultGrain; results do not depend on the
+	// executor's thread count.
+
+	DRect GetCombinedRect(const DRect*rects, size_t count, DExecutor&executor, size_t grain = 0);
+	DRect GetCombinedRect(const DRectArray&rectarray, DExecutor&executor, size_t grain = 0);
+
+	// results[i] = rects[i].Intersects(rect)
+	void IntersectsRect(const DRect*rects, size_t count, const DRect&rect, uint8_t*results, DExecutor&executor, size_t grain = 0);
+
+	// results[i] = rects[i].IsContainedIn(rect)
+	void ContainedInRect(const DRect*rects, size_t count, const DRect&rect, uint8_t*results, DExecutor&executor, size_t grain = 0);
+
+	// results[i] = polygon.PointInPolygon(points[i])
+	void PointsInPolygon(const DPolygon&polygon, const DPoint*points, size_t count, uint8_t*results, DExecutor&executor, size_t grain = 0);
+
+	// rects[i].Move(xAmount, yAmount), in place
+	void MoveRects(DRect*rects, size_t count, float xAmount, float yAmount, DExecutor&executor, size_t grain = 0);
+
+	// results[i] = rects[i].getRotatedBounds(angle, origin)
+	void GetRotatedBounds(const DRect*rects, size_t count, float angle, const DPoint&origin, DRect*results, DExecutor&executor, size_t grain = 0);
+
+}
@@ -0,0 +1,281 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKPolygon.h"
+#include "DKRobust.h"
+
+#include <math.h>
+
+using namespace DKGeometry;
+
+
+bool DKGeometry::SegmentIntersectsRect(const DPoint & a, const DPoint & b, const DRect & rect)
+{
+	if (rect.PointInRect(a) || rect.PointInRect(b)) return true;
+
+	// Liang-Barsky clip of the segment against the four slabs
+	float dx = b.x - a.x;
+	float dy = b.y - a.y;
+	float p[4] = { -dx, dx, -dy, dy };
+	float q[4] = { a.x - rect.left, rect.right - a.x, a.y - rect.top, rect.bottom - a.y };
+	float t0 = 0.f;
+	float t1 = 1.f;
+
+	for (int i = 0; i < 4; i++)
+	{
+		if (p[i] == 0)
+		{
+			if (q[i] < 0) return false; // parallel and outside this slab
+			continue;
+		}
+		float t = q[i] / p[i];
+		if (p[i] < 0) {
+			if (t > t1) return false;
+			if (t > t0) t0 = t;
+		}
+		else {
+			if (t < t0) return false;
+			if (t < t1) t1 = t;
+		}
+	}
+	return t0 <= t1;
+}
+
+bool DKGeometry::SegmentsIntersect(const DPoint & a1, const DPoint & a2, const DPoint & b1, const DPoint & b2)
+{
+	return SegmentsTouch(a1, a2, b1, b2);
+}
+
+
+DKGeometry::DPolyline::DPolyline(const DPointArray & vertices)
+	: points(vertices)
+{
+	rebuildBounds();
+}
+
+DKGeometry::DPolyline::DPolyline(DPointArray && vertices)
+	: points(std::move(vertices))
+{
+	rebuildBounds();
+}
+
+void DKGeometry::DPolyline::setPoints(const DPointArray & vertices)
+{
+	points = vertices;
+	rebuildBounds();
+}
+
+void DKGeometry::DPolyline::addPoint(const DPoint & point)
+{
+	points.push_back(point);
+	boundsRect.CombineWith(DRect(point, point));
+
+	size_t segments = segmentCount();
+	size_t chunks = (segments + ChunkSize - 1) / ChunkSize;
+	chunkBounds.resize(chunks);
+
+	// the new segment and, for polygons, the closing segment both live in the last two chunks
+	if (chunks > 1) updateChunk(chunks - 2);
+	if (chunks > 0) updateChunk(chunks - 1);
+}
+
+void DKGeometry::DPolyline::clear()
+{
+	points.clear();
+	rebuildBounds();
+}
+
+DLine DKGeometry::DPolyline::segment(size_t index) const
+{
+	return DLine(points[index], segmentEnd(index));
+}
+
+float DKGeometry::DPolyline::length() const
+{
+	float total = 0;
+	for (size_t i = 0, count = segmentCount(); i < count; i++)
+	{
+		const DPoint&a = points[i];
+		const DPoint&b = segmentEnd(i);
+		total += sqrtf((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+	}
+	return total;
+}
+
+void DKGeometry::DPolyline::rebuildBounds()
+{
+	float l = DKInfinity, t = DKInfinity, r = DKNegInfinity, b = DKNegInfinity;
+	for (const auto&eachPoint : points)
+	{
+		l = (std::min)(l, eachPoint.x);
+		t = (std::min)(t, eachPoint.y);
+		r = (std::max)(r, eachPoint.x);
+		b = (std::max)(b, eachPoint.y);
+	}
+	boundsRect = DRect(l, t, r, b);
+
+	size_t segments = segmentCount();
+	chunkBounds.resize((segments + ChunkSize - 1) / ChunkSize);
+	for (size_t chunk = 0; chunk < chunkBounds.size(); chunk++)
+	{
+		updateChunk(chunk);
+	}
+}
+
+void DKGeometry::DPolyline::updateChunk(size_t chunk)
+{
+	size_t first = chunk * ChunkSize;
+	size_t last = (std::min)(first + ChunkSize, segmentCount());
+
+	DRect chunkRect(points[first], points[first]);
+	for (size_t i = first; i < last; i++)
+	{
+		const DPoint&end = segmentEnd(i);
+		if (end.x < chunkRect.left) chunkRect.left = end.x;
+		if (end.x > chunkRect.right) chunkRect.right = end.x;
+		if (end.y < chunkRect.top) chunkRect.top = end.y;
+		if (end.y > chunkRect.bottom) chunkRect.bottom = end.y;
+	}
+	chunkBounds[chunk] = chunkRect;
+}
+
+template <class SegmentTest>
+bool DKGeometry::DPolyline::anySegment(const DRect & area, SegmentTest test) const
+{
+	if (points.empty() || !boundsRect.Intersects(area)) return false;
+
+	size_t segments = segmentCount();
+	for (size_t chunk = 0; chunk < chunkBounds.size(); chunk++)
+	{
+		if (!chunkBounds[chunk].Intersects(area)) continue;
+
+		size_t last = (std::min)((chunk + 1) * ChunkSize, segments);
+		for (size_t i = chunk * ChunkSize; i < last; i++)
+		{
+			if (test(points[i], segmentEnd(i))) return true;
+		}
+	}
+	return false;
+}
+
+bool DKGeometry::DPolyline::Intersects(const DRect & rect) const
+{
+	DRect area(rect);
+	area.Normalize();
+
+	if (points.size() == 1) return area.PointInRect(points.front());
+
+	return anySegment(area, [&area](const DPoint&a, const DPoint&b) {
+		return SegmentIntersectsRect(a, b, area);
+	});
+}
+
+bool DKGeometry::DPolyline::CrossesRect(const DRect & rect) const
+{
+	DRect area(rect);
+	area.Normalize();
+
+	return anySegment(area, [&area](const DPoint&a, const DPoint&b) {
+		bool aInside = a.x > area.left && a.x < area.right && a.y > area.top && a.y < area.bottom;
+		bool bInside = b.x > area.left && b.x < area.right && b.y > area.top && b.y < area.bottom;
+		if (aInside && bInside) return false;
+		return SegmentIntersectsRect(a, b, area);
+	});
+}
+
+bool DKGeometry::DPolyline::LineCrosses(const DLine & line) const
+{
+	DRect area(line.start, line.end);
+	area.Normalize();
+
+	return anySegment(area, [&line](const DPoint&a, const DPoint&b) {
+		return SegmentsIntersect(a, b, line.start, line.end);
+	});
+}
+
+bool DKGeometry::DPolyline::IsContainedIn(const DRect & rect) const
+{
+	return !points.empty() && boundsRect.IsContainedIn(rect);
+}
+
+
+float DKGeometry::DPolygon::area() const
+{
+	// shoelace formula, positive for clockwise winding in y-down coordinates
+	float total = 0;
+	for (size_t i = 0, count = points.size(); i < count; i++)
+	{
+		const DPoint&a = points[i];
+		const DPoint&b = segmentEnd(i);
+		total += a.x * b.y - b.x * a.y;
+	}
+	return total / 2.f;
+}
+
+bool DKGeometry::DPolygon::PointInPolygon(const DPoint & point) const
+{
+	if (points.size() < 3 || !boundsRect.PointInRect(point)) return false;
+
+	bool inside = false;
+	size_t segments = segmentCount();
+	for (size_t chunk = 0; chunk < chunkBounds.size(); chunk++)
+	{
+		// a chunk can only flip the result if it spans the ray's y and reaches right of the point
+		const DRect&chunkRect = chunkBounds[chunk];
+		if (point.y < chunkRect.top || point.y > chunkRect.bottom || point.x > chunkRect.right) continue;
+
+		size_t last = (std::min)((chunk + 1) * ChunkSize, segments);
+		for (size_t i = chunk * ChunkSize; i < last; i++)
+		{
+			const DPoint&a = points[i];
+			const DPoint&b = segmentEnd(i);
+			if ((a.y > point.y) != (b.y > point.y) &&
+				point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x)
+			{
+				inside = !inside;
+			}
+		}
+	}
+	return inside;
+}
+
+bool DKGeometry::DPolygon::Intersects(const DRect & rect) const
+{
+	if (points.size() < 3) return DPolyline::Intersects(rect);
+
+	DRect area(rect);
+	area.Normalize();
+	if (!boundsRect.Intersects(area)) return false;
+
+	// an edge touching the rect settles it
+	if (DPolyline::Intersects(area)) return true;
+
+	// otherwise one shape is wholly inside the other, or they are disjoint
+	if (area.PointInRect(points.front())) return true;
+	return PointInPolygon(area.topLeft());
+}
@@ -0,0 +1,124 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+#include "DKGeometry.h"
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Returns true if the segment a-b touches the (normalized) rectangle.</summary>
+	bool SegmentIntersectsRect(const DPoint&a, const DPoint&b, const DRect&rect);
+
+	/// <summary>
+	/// Returns true if the segments a1-a2 and b1-b2 share at least one point.
+	/// Exact, see SegmentsTouch.</summary>
+	bool SegmentsIntersect(const DPoint&a1, const DPoint&a2, const DPoint&b1, const DPoint&b2);
+
+	class DPolyline
+	{
+	public:
+		// number of segments covered by each cached chunk bound
+		static const size_t ChunkSize = 32;
+
+		inline DPolyline() : boundsRect(DKInfinity, DKInfinity, DKNegInfinity, DKNegInfinity) {}
+
+		/// <summary>
+		/// Constructs a DPolyline from a list of vertices.</summary>
+		/// <param name="vertices">source vertices, copied contiguously</param>
+		DPolyline(const DPointArray&vertices);
+		DPolyline(DPointArray&&vertices);
+
+		virtual ~DPolyline() {}
+
+		void setPoints(const DPointArray&vertices);
+		void addPoint(const DPoint&point);
+		void clear();
+
+		inline const DPointArray& getPoints() const { return points; }
+		inline size_t pointCount() const { return points.size(); }
+		inline bool isEmpty() const { return points.empty(); }
+		inline const DPoint& pointAt(size_t index) const { return points[index]; }
+
+		virtual size_t segmentCount() const { return points.size() > 1 ? points.size() - 1 : 0; }
+		DLine segment(size_t index) const;
+
+		// cached bounds of every vertex, O(1)
+		inline DRect bounds() const { return boundsRect; }
+		inline size_t chunkCount() const { return chunkBounds.size(); }
+		inline const DRect& chunkBoundsAt(size_t index) const { return chunkBounds[index]; }
+
+		float length() const;
+
+		// true if any segment touches the rect
+		bool Intersects(const DRect&rect) const;
+
+		// true if any segment crosses the rect's boundary, as in DRect::LineCrossesRect
+		bool CrossesRect(const DRect&rect) const;
+
+		// true if any segment shares a point with the line segment
+		bool LineCrosses(const DLine&line) const;
+
+		bool IsContainedIn(const DRect&rect) const;
+
+	protected:
+		void rebuildBounds();
+		void updateChunk(size_t chunk);
+
+		inline const DPoint& segmentEnd(size_t index) const {
+			return (index + 1 < points.size()) ? points[index + 1] : points.front();
+		}
+
+		template <class SegmentTest>
+		bool anySegment(const DRect&area, SegmentTest test) const;
+
+		DPointArray points;
+		std::vector<DRect> chunkBounds;
+		DRect boundsRect;
+	};
+
+	class DPolygon : public DPolyline
+	{
+	public:
+		inline DPolygon() {}
+		DPolygon(const DPointArray&vertices) : DPolyline(vertices) { rebuildBounds(); }
+		DPolygon(DPointArray&&vertices) : DPolyline(std::move(vertices)) { rebuildBounds(); }
+
+		// includes the closing segment from the last vertex back to the first
+		size_t segmentCount() const override { return points.size() > 2 ? points.size() : DPolyline::segmentCount(); }
+
+		float area() const;
+
+		/// <summary>
+		/// Even-odd point in polygon test.</summary>
+		/// <returns>
+		/// true if the point lies inside the polygon
+		/// </returns>
+		bool PointInPolygon(const DPoint&point) const;
+
+		// true if the polygon's area and the rect overlap
+		bool Intersects(const DRect&rect) const;
+	};
+
+}
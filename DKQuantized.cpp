@@ -0,0 +1,253 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKQuantized.h"
+
+#include <math.h>
+
+#ifdef DKGEOMETRY_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace DKGeometry;
+
+static const uint32_t QuantizedMax = 65535;
+
+// smallest float step that reaches the far edge from origin in QuantizedMax steps
+static float quantizedStep(float origin, float extent, float farEdge)
+{
+	if (!(extent > 0)) return 0;
+	float step = extent / QuantizedMax;
+	while (origin + (float)QuantizedMax * step < farEdge)
+	{
+		step = nextafterf(step, INFINITY);
+	}
+	return step;
+}
+
+DKGeometry::DQuantizedFrame::DQuantizedFrame(const DRect & bounds)
+{
+	DRect normalized(bounds);
+	normalized.Normalize();
+	x = normalized.left;
+	y = normalized.top;
+	stepX = quantizedStep(x, normalized.Width(), normalized.right);
+	stepY = quantizedStep(y, normalized.Height(), normalized.bottom);
+}
+
+// largest q whose decoded value is <= value, or the smallest >= value when rounding up
+static uint16_t encodeValue(float value, float origin, float step, bool up)
+{
+	if (step == 0) return 0;
+
+	double scaled = ((double)value - origin) / step;
+	double rounded = up ? ceil(scaled) : floor(scaled);
+	int64_t q = rounded < 0 ? 0 : (rounded > QuantizedMax ? QuantizedMax : (int64_t)rounded);
+
+	// settle on the float decode used by the kernels
+	if (up) {
+		while (q < QuantizedMax && origin + (float)q * step < value) q++;
+		while (q > 0 && origin + (float)(q - 1) * step >= value) q--;
+	}
+	else {
+		while (q > 0 && origin + (float)q * step > value) q--;
+		while (q < QuantizedMax && origin + (float)(q + 1) * step <= value) q++;
+	}
+	return (uint16_t)q;
+}
+
+DQuantizedRect DKGeometry::DQuantizedFrame::encode(const DRect & rect) const
+{
+	DRect normalized(rect);
+	normalized.Normalize();
+
+	DQuantizedRect result;
+	result.left = encodeValue(normalized.left, x, stepX, false);
+	result.top = encodeValue(normalized.top, y, stepY, false);
+	result.right = encodeValue(normalized.right, x, stepX, true);
+	result.bottom = encodeValue(normalized.bottom, y, stepY, true);
+	return result;
+}
+
+void DKGeometry::QuantizeRects(const DRect * rects, size_t count, const DQuantizedFrame & frame, DQuantizedRect * out)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = frame.encode(rects[i]);
+	}
+}
+
+void DKGeometry::DequantizeRects(const DQuantizedRect * rects, size_t count, const DQuantizedFrame & frame, DRect * out)
+{
+	size_t i = 0;
+#ifdef DKGEOMETRY_SSE2
+	// two rects per 16-byte load: widen the 16-bit lanes, convert, scale and offset
+	const __m128 origin = _mm_setr_ps(frame.x, frame.y, frame.x, frame.y);
+	const __m128 step = _mm_setr_ps(frame.stepX, frame.stepY, frame.stepX, frame.stepY);
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128i packed = _mm_loadu_si128((const __m128i*)(rects + i));
+		__m128 first = _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, zero));
+		__m128 second = _mm_cvtepi32_ps(_mm_unpackhi_epi16(packed, zero));
+		_mm_storeu_ps(&out[i].left, _mm_add_ps(origin, _mm_mul_ps(first, step)));
+		_mm_storeu_ps(&out[i + 1].left, _mm_add_ps(origin, _mm_mul_ps(second, step)));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		out[i] = frame.decode(rects[i]);
+	}
+}
+
+
+bool DKGeometry::EncodeSortedIds(const uint64_t * ids, size_t count, std::vector<uint8_t>& out)
+{
+	uint64_t previous = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (i && ids[i] < previous) return false;
+
+		uint64_t delta = ids[i] - previous;
+		previous = ids[i];
+		while (delta >= 0x80)
+		{
+			out.push_back((uint8_t)(delta | 0x80));
+			delta >>= 7;
+		}
+		out.push_back((uint8_t)delta);
+	}
+	return true;
+}
+
+bool DKGeometry::DecodeSortedIds(const uint8_t * data, size_t size, std::vector<uint64_t>& ids)
+{
+	uint64_t previous = 0;
+	size_t i = 0;
+	while (i < size)
+	{
+		uint64_t delta = 0;
+		int shift = 0;
+		for (;;)
+		{
+			if (i >= size || shift > 63) return false;
+			uint8_t byte = data[i++];
+			delta |= (uint64_t)(byte & 0x7f) << shift;
+			if (!(byte & 0x80)) break;
+			shift += 7;
+		}
+		previous += delta;
+		ids.push_back(previous);
+	}
+	return true;
+}
+
+
+bool DKGeometry::DCompactRectIndex::Build(const DRectIndex & index)
+{
+	clear();
+	const IDRArray&sourceItems = index.getItems();
+	const std::vector<DRectIndexNode>&sourceNodes = index.getNodes();
+	if (sourceNodes.empty()) return true;
+
+	for (const auto&eachItem : sourceItems)
+	{
+		if (eachItem.id > UINT32_MAX) return false;
+	}
+
+	size_t nodeTotal = sourceNodes.size();
+	leafCount = index.leafNodeCount();
+	rootBounds = sourceNodes.back().bounds;
+	nodeBounds.resize(nodeTotal);
+	nodeFirst.resize(nodeTotal);
+	nodeCount.resize(nodeTotal);
+	items.resize(sourceItems.size());
+	ids.resize(sourceItems.size());
+
+	// top down, so every parent's decoded bounds exist before its children are encoded
+	std::vector<DRect> decoded(nodeTotal);
+	decoded[nodeTotal - 1] = rootBounds;
+	nodeBounds[nodeTotal - 1] = DQuantizedRect{ 0, 0, 0, 0 };
+	for (size_t node = nodeTotal; node-- > 0; )
+	{
+		const DRectIndexNode&source = sourceNodes[node];
+		nodeFirst[node] = source.first;
+		nodeCount[node] = (uint16_t)source.count;
+		DQuantizedFrame frame(decoded[node]);
+
+		if (node < leafCount)
+		{
+			for (uint32_t i = source.first; i < source.first + source.count; i++)
+			{
+				items[i] = frame.encode(sourceItems[i]);
+				ids[i] = (uint32_t)sourceItems[i].id;
+			}
+			continue;
+		}
+
+		for (uint32_t child = source.first; child < source.first + source.count; child++)
+		{
+			nodeBounds[child] = frame.encode(sourceNodes[child].bounds);
+			decoded[child] = frame.decode(nodeBounds[child]);
+		}
+	}
+	return true;
+}
+
+bool DKGeometry::DCompactRectIndex::Build(const IDRArray & rects)
+{
+	DRectIndex index(rects);
+	return Build(index);
+}
+
+void DKGeometry::DCompactRectIndex::clear()
+{
+	rootBounds = DRect();
+	nodeBounds.clear();
+	nodeFirst.clear();
+	nodeCount.clear();
+	leafCount = 0;
+	items.clear();
+	ids.clear();
+}
+
+size_t DKGeometry::DCompactRectIndex::bytesUsed() const
+{
+	return nodeBounds.size() * (sizeof(DQuantizedRect) + sizeof(uint32_t) + sizeof(uint16_t)) +
+		items.size() * (sizeof(DQuantizedRect) + sizeof(uint32_t));
+}
+
+size_t DKGeometry::DCompactRectIndex::Count(const DRect & area) const
+{
+	size_t count = 0;
+	Visit(area, [&count](uint32_t, const DRect&) {
+		count++;
+		return true;
+	});
+	return count;
+}
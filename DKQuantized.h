@@ -0,0 +1,159 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKRectIndex.h"
+
+namespace DKGeometry
+{
+	// rect with 16-bit coordinates relative to a DQuantizedFrame, 8 bytes
+	struct DQuantizedRect
+	{
+		uint16_t left, top, right, bottom;
+	};
+
+	/// <summary>
+	/// Maps 16-bit coordinates onto a parent bounds: value = origin + q * step.
+	/// Encoding rounds outward (left/top down, right/bottom up), so the decoded
+	/// rect always contains the original; it may grow by up to one step,
+	/// 1/65535 of the parent's extent, on each side.</summary>
+	struct DQuantizedFrame
+	{
+		float x = 0, y = 0;
+		float stepX = 0, stepY = 0;
+
+		DQuantizedFrame() {}
+		explicit DQuantizedFrame(const DRect&bounds);
+
+		DQuantizedRect encode(const DRect&rect) const;
+		inline DRect decode(const DQuantizedRect&q) const {
+			return DRect(x + (float)q.left * stepX, y + (float)q.top * stepY,
+				x + (float)q.right * stepX, y + (float)q.bottom * stepY);
+		}
+	};
+
+	// batch encode and decode; decoding gives exactly DQuantizedFrame::decode
+	void QuantizeRects(const DRect*rects, size_t count, const DQuantizedFrame&frame, DQuantizedRect*out);
+	void DequantizeRects(const DQuantizedRect*rects, size_t count, const DQuantizedFrame&frame, DRect*out);
+
+	/// <summary>
+	/// Delta encoding for ascending id lists: each gap to the previous id is
+	/// written as a little-endian base-128 varint, so dense lists take about
+	/// one byte per id. Encoding returns false if the ids are not ascending.</summary>
+	bool EncodeSortedIds(const uint64_t*ids, size_t count, std::vector<uint8_t>&out);
+	// appends to ids; false if the data ends inside a varint
+	bool DecodeSortedIds(const uint8_t*data, size_t size, std::vector<uint64_t>&ids);
+
+	/// <summary>
+	/// Compact copy of a DRectIndex for bandwidth bound queries.
+	/// Node bounds are quantized against their parent's decoded bounds and
+	/// items against their leaf's, ids are 32-bit, and children of a node are
+	/// stored together so a whole node decodes in one batch. That is 14 bytes
+	/// per node and 12 per item instead of 24 each.
+	///
+	/// Because rounding is outward, queries never miss a match but can report
+	/// rects lying within one quantization step of the area; refine with the
+	/// exact rects where that matters.</summary>
+	class DCompactRectIndex
+	{
+	public:
+		DCompactRectIndex() {}
+
+		// false, leaving the index empty, if an id does not fit in 32 bits
+		bool Build(const DRectIndex&index);
+		bool Build(const IDRArray&rects);
+		void clear();
+
+		inline size_t size() const { return ids.size(); }
+		inline bool isEmpty() const { return ids.empty(); }
+		inline DRect bounds() const { return rootBounds; }
+		size_t bytesUsed() const;
+
+		/// <summary>
+		/// Calls visit(id, rect) for every item whose decoded rect touches area;
+		/// rect is the conservative decoded bounds. Returning false stops.</summary>
+		template <class ItemVisitor>
+		void Visit(const DRect&area, ItemVisitor visit) const
+		{
+			if (ids.empty()) return;
+
+			DRect query(area);
+			query.Normalize();
+			if (!DRectIndexView::touches(rootBounds, query)) return;
+
+			struct Pending { size_t node; DRect bounds; };
+			Pending stack[256];
+			DRect decoded[DRectIndex::NodeSize];
+			size_t depth = 0;
+			stack[depth++] = { nodeFirst.size() - 1, rootBounds };
+			while (depth)
+			{
+				Pending current = stack[--depth];
+				size_t first = nodeFirst[current.node];
+				size_t count = nodeCount[current.node];
+				DQuantizedFrame frame(current.bounds);
+
+				if (current.node < leafCount)
+				{
+					DequantizeRects(items.data() + first, count, frame, decoded);
+					for (size_t i = 0; i < count; i++)
+					{
+						if (DRectIndexView::touches(decoded[i], query) && !visit(ids[first + i], decoded[i])) return;
+					}
+					continue;
+				}
+
+				DequantizeRects(nodeBounds.data() + first, count, frame, decoded);
+				for (size_t i = count; i-- > 0; )
+				{
+					if (DRectIndexView::touches(decoded[i], query)) stack[depth++] = { first + i, decoded[i] };
+				}
+			}
+		}
+
+		template <class Alloc>
+		void Search(const DRect&area, std::vector<uint32_t, Alloc>&results) const
+		{
+			Visit(area, [&results](uint32_t id, const DRect&) {
+				results.push_back(id);
+				return true;
+			});
+		}
+
+		size_t Count(const DRect&area) const;
+
+	private:
+		DRect rootBounds;
+		// node i's bounds are relative to its parent; the root's entry is unused
+		std::vector<DQuantizedRect> nodeBounds;
+		std::vector<uint32_t> nodeFirst;
+		std::vector<uint16_t> nodeCount;
+		size_t leafCount = 0;
+
+		std::vector<DQuantizedRect> items;
+		std::vector<uint32_t> ids;
+	};
+
+}
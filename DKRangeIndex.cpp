@@ -0,0 +1,357 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKRangeIndex.h"
+
+#include <numeric>
+
+using namespace DKGeometry;
+
+
+void DKGeometry::DRangeIndex::add(const DRange & range, uint64_t id)
+{
+	applyEdits();
+	starts.push_back(range.start);
+	ends.push_back(range.limit());
+	ids.push_back(id);
+	indexed = false;
+}
+
+void DKGeometry::DRangeIndex::build(const DRange * ranges, const uint64_t * rangeIds, size_t count)
+{
+	clear();
+	starts.resize(count);
+	ends.resize(count);
+	ids.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		starts[i] = ranges[i].start;
+		ends[i] = ranges[i].limit();
+		ids[i] = rangeIds[i];
+	}
+	indexed = false;
+	ensureIndexed();
+}
+
+void DKGeometry::DRangeIndex::build(const std::vector<DRange>& ranges, const std::vector<uint64_t>& rangeIds)
+{
+	build(ranges.data(), rangeIds.data(), (std::min)(ranges.size(), rangeIds.size()));
+}
+
+void DKGeometry::DRangeIndex::clear()
+{
+	starts.clear();
+	ends.clear();
+	maxEnds.clear();
+	ids.clear();
+	rootLevel = -1;
+	indexed = true;
+	clearEdits();
+}
+
+void DKGeometry::DRangeIndex::clearEdits()
+{
+	edits.assign(1, { 0, 0, false });
+}
+
+void DKGeometry::DRangeIndex::ensureIndexed() const
+{
+	if (indexed) return;
+
+	size_t n = starts.size();
+	bool sorted = std::is_sorted(starts.begin(), starts.end());
+	if (!sorted)
+	{
+		std::vector<uint32_t> order(n);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+			return starts[a] < starts[b];
+		});
+
+		std::vector<uint32_t> sortedStarts(n), sortedEnds(n);
+		std::vector<uint64_t> sortedIds(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			sortedStarts[i] = starts[order[i]];
+			sortedEnds[i] = ends[order[i]];
+			sortedIds[i] = ids[order[i]];
+		}
+		starts.swap(sortedStarts);
+		ends.swap(sortedEnds);
+		ids.swap(sortedIds);
+	}
+
+	// implicit tree over the sorted array: node i at level k has its
+	// children at i -/+ 2^(k-1), leaves are the even indices
+	maxEnds.resize(n);
+	rootLevel = -1;
+	indexed = true;
+	if (n == 0) return;
+
+	int64_t lastIndex = 0;
+	uint32_t last = 0;
+	for (size_t i = 0; i < n; i += 2)
+	{
+		lastIndex = (int64_t)i;
+		last = maxEnds[i] = ends[i];
+	}
+
+	int k;
+	for (k = 1; (int64_t(1) << k) <= (int64_t)n; k++)
+	{
+		int64_t x = int64_t(1) << (k - 1);
+		int64_t i0 = (x << 1) - 1;
+		int64_t step = x << 2;
+		for (int64_t i = i0; i < (int64_t)n; i += step)
+		{
+			uint32_t el = maxEnds[i - x];
+			uint32_t er = (i + x < (int64_t)n) ? maxEnds[i + x] : last;
+			uint32_t e = ends[i];
+			if (el > e) e = el;
+			if (er > e) e = er;
+			maxEnds[i] = e;
+		}
+		lastIndex = ((lastIndex >> k) & 1) ? lastIndex - x : lastIndex + x;
+		if (lastIndex < (int64_t)n && maxEnds[lastIndex] > last)
+			last = maxEnds[lastIndex];
+	}
+	rootLevel = k - 1;
+}
+
+template <class Visit>
+void DKGeometry::DRangeIndex::query(int64_t st, int64_t en, Visit visit) const
+{
+	ensureIndexed();
+	if (rootLevel < 0 || st >= en) return;
+
+	struct StackItem { int64_t x; int k; int w; };
+	StackItem stack[64];
+	int64_t n = (int64_t)starts.size();
+	int t = 0;
+
+	stack[t++] = { (int64_t(1) << rootLevel) - 1, rootLevel, 0 };
+	while (t)
+	{
+		StackItem z = stack[--t];
+		if (z.k <= 3)
+		{
+			// small subtree, scan it directly
+			int64_t i0 = z.x >> z.k << z.k;
+			int64_t i1 = i0 + (int64_t(1) << (z.k + 1)) - 1;
+			if (i1 > n) i1 = n;
+			for (int64_t i = i0; i < i1 && starts[i] < en; i++)
+			{
+				if (st < ends[i]) visit((size_t)i);
+			}
+		}
+		else if (z.w == 0)
+		{
+			// revisit this node after its left child
+			int64_t y = z.x - (int64_t(1) << (z.k - 1));
+			stack[t++] = { z.x, z.k, 1 };
+			if (y >= n || maxEnds[y] > st)
+				stack[t++] = { y, z.k - 1, 0 };
+		}
+		else if (z.x < n && starts[z.x] < en)
+		{
+			if (st < ends[z.x]) visit((size_t)z.x);
+			stack[t++] = { z.x + (int64_t(1) << (z.k - 1)), z.k - 1, 0 };
+		}
+	}
+}
+
+int64_t DKGeometry::DRangeIndex::mapForward(uint32_t base) const
+{
+	auto it = std::upper_bound(edits.begin(), edits.end(), base, [](uint32_t value, const EditSegment&seg) {
+		return value < seg.base;
+	});
+	const EditSegment&seg = *(it - 1);
+	return seg.collapsed ? seg.current : (int64_t)seg.current + (base - seg.base);
+}
+
+int64_t DKGeometry::DRangeIndex::mapBackward(uint32_t position) const
+{
+	// largest base position whose current position is <= position
+	auto it = std::upper_bound(edits.begin(), edits.end(), position, [](uint32_t value, const EditSegment&seg) {
+		return value < seg.current;
+	});
+	if (it == edits.begin()) return -1;
+
+	size_t i = (it - edits.begin()) - 1;
+	const EditSegment&seg = edits[i];
+	int64_t limit = (i + 1 < edits.size()) ? (int64_t)edits[i + 1].base - 1 : INT64_MAX;
+	if (seg.collapsed) return limit;
+	return (std::min)((int64_t)seg.base + (position - seg.current), limit);
+}
+
+void DKGeometry::DRangeIndex::stab(uint32_t position, DRangeHitArray & results) const
+{
+	int64_t base = mapBackward(position);
+	if (base < 0) return;
+
+	query(base, base + 1, [this, &results](size_t i) {
+		int64_t s = mapForward(starts[i]);
+		int64_t e = mapForward(ends[i]);
+		results.push_back({ DRange((uint32_t)s, (uint32_t)(e - s)), ids[i] });
+	});
+}
+
+void DKGeometry::DRangeIndex::stab(uint32_t position, std::vector<uint64_t>& results) const
+{
+	int64_t base = mapBackward(position);
+	if (base < 0) return;
+
+	query(base, base + 1, [this, &results](size_t i) { results.push_back(ids[i]); });
+}
+
+void DKGeometry::DRangeIndex::overlapping(const DRange & range, DRangeHitArray & results) const
+{
+	if (range.length == 0) return;
+	int64_t first = mapBackward(range.start);
+	int64_t last = mapBackward(range.start + range.length - 1);
+	if (last < 0) return;
+
+	query(first, last + 1, [this, &results](size_t i) {
+		int64_t s = mapForward(starts[i]);
+		int64_t e = mapForward(ends[i]);
+		if (s < e) results.push_back({ DRange((uint32_t)s, (uint32_t)(e - s)), ids[i] });
+	});
+}
+
+void DKGeometry::DRangeIndex::overlapping(const DRange & range, std::vector<uint64_t>& results) const
+{
+	if (range.length == 0) return;
+	int64_t first = mapBackward(range.start);
+	int64_t last = mapBackward(range.start + range.length - 1);
+	if (last < 0) return;
+
+	// empty ranges satisfy the translated bounds too, so filter them here
+	query(first, last + 1, [this, &results](size_t i) {
+		if (starts[i] == ends[i]) return;
+		if (edits.size() > 1 && mapForward(starts[i]) == mapForward(ends[i])) return;
+		results.push_back(ids[i]);
+	});
+}
+
+void DKGeometry::DRangeIndex::getRanges(DRangeHitArray & results) const
+{
+	ensureIndexed();
+	results.reserve(results.size() + starts.size());
+	for (size_t i = 0; i < starts.size(); i++)
+	{
+		int64_t s = mapForward(starts[i]);
+		int64_t e = mapForward(ends[i]);
+		results.push_back({ DRange((uint32_t)s, (uint32_t)(e - s)), ids[i] });
+	}
+}
+
+void DKGeometry::DRangeIndex::splitEdits(int64_t position)
+{
+	for (size_t i = 0; i < edits.size(); i++)
+	{
+		const EditSegment&seg = edits[i];
+		if (seg.collapsed || seg.current >= position) continue;
+
+		int64_t length = (i + 1 < edits.size()) ? (int64_t)edits[i + 1].base - seg.base : INT64_MAX;
+		if (position - seg.current < length)
+		{
+			EditSegment split = { (uint32_t)(seg.base + (position - seg.current)), (uint32_t)position, false };
+			edits.insert(edits.begin() + i + 1, split);
+			return;
+		}
+	}
+}
+
+void DKGeometry::DRangeIndex::mergeEdits()
+{
+	size_t out = 0;
+	for (size_t i = 1; i < edits.size(); i++)
+	{
+		EditSegment&prev = edits[out];
+		const EditSegment&seg = edits[i];
+		bool sameCollapse = prev.collapsed && seg.collapsed && prev.current == seg.current;
+		bool sameLinear = !prev.collapsed && !seg.collapsed &&
+			(int64_t)seg.current == (int64_t)prev.current + (seg.base - prev.base);
+		if (!sameCollapse && !sameLinear) edits[++out] = seg;
+	}
+	edits.resize(out + 1);
+}
+
+void DKGeometry::DRangeIndex::insertText(uint32_t offset, uint32_t length)
+{
+	if (length == 0) return;
+
+	splitEdits(offset);
+	for (auto&seg : edits)
+	{
+		if (seg.current >= offset) seg.current += length;
+	}
+	mergeEdits();
+
+	if (edits.size() > MaxPendingEdits) applyEdits();
+}
+
+void DKGeometry::DRangeIndex::deleteText(uint32_t offset, uint32_t length)
+{
+	if (length == 0) return;
+
+	uint32_t limit = offset + length;
+	splitEdits(offset);
+	splitEdits(limit);
+	for (auto&seg : edits)
+	{
+		if (seg.current >= limit) {
+			seg.current -= length;
+		}
+		else if (seg.current >= offset) {
+			seg.current = offset;
+			seg.collapsed = true;
+		}
+	}
+	mergeEdits();
+
+	if (edits.size() > MaxPendingEdits) applyEdits();
+}
+
+void DKGeometry::DRangeIndex::applyEdits()
+{
+	if (edits.size() == 1 && edits[0].current == 0 && !edits[0].collapsed)
+		return;
+
+	// the map is monotone, so start order survives and only max ends need rebuilding
+	for (size_t i = 0; i < starts.size(); i++)
+	{
+		starts[i] = (uint32_t)mapForward(starts[i]);
+		ends[i] = (uint32_t)mapForward(ends[i]);
+	}
+	clearEdits();
+
+	bool wasIndexed = indexed;
+	indexed = false;
+	if (wasIndexed) ensureIndexed();
+}
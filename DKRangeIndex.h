@@ -0,0 +1,117 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+#include "DKGeometry.h"
+
+namespace DKGeometry
+{
+	struct DRangeHit
+	{
+		DRange range;
+		uint64_t id;
+	};
+
+	typedef std::vector<DRangeHit> DRangeHitArray;
+
+	/// <summary>
+	/// Interval index over DRanges with payload ids.
+	/// Ranges are kept sorted by start with an implicit augmented tree
+	/// (max end per node) laid over the sorted array, so stabbing and
+	/// overlap queries cost O(log n + hits).
+	///
+	/// Text edits do not touch the ranges. They are recorded in a small
+	/// monotone position map and queries are translated through it; the map
+	/// is folded into the ranges once it grows past MaxPendingEdits.
+	/// Text inserted at the end of a range extends it, text inserted at its
+	/// start shifts it, and ranges deleted entirely collapse to empty and
+	/// stop matching queries.
+	///
+	/// The index over added ranges is rebuilt on the first query after add,
+	/// so const queries may write to the index and need external locking if
+	/// shared between threads; call a query once after loading to settle it.</summary>
+	class DRangeIndex
+	{
+	public:
+		static const size_t MaxPendingEdits = 64;
+
+		DRangeIndex() { clearEdits(); }
+
+		// ranges added after a query are indexed lazily on the next query
+		void add(const DRange&range, uint64_t id);
+		void build(const DRange*ranges, const uint64_t*ids, size_t count);
+		void build(const std::vector<DRange>&ranges, const std::vector<uint64_t>&ids);
+		void clear();
+
+		inline size_t size() const { return starts.size(); }
+		inline bool isEmpty() const { return starts.empty(); }
+
+		// ranges covering position
+		void stab(uint32_t position, DRangeHitArray&results) const;
+		void stab(uint32_t position, std::vector<uint64_t>&ids) const;
+
+		// ranges sharing at least one position with range
+		void overlapping(const DRange&range, DRangeHitArray&results) const;
+		void overlapping(const DRange&range, std::vector<uint64_t>&ids) const;
+
+		// shift every range after a text edit at offset
+		void insertText(uint32_t offset, uint32_t length);
+		void deleteText(uint32_t offset, uint32_t length);
+
+		// fold pending edits into the stored ranges
+		void applyEdits();
+
+		// all ranges in current coordinates, in start order
+		void getRanges(DRangeHitArray&results) const;
+
+	private:
+		struct EditSegment
+		{
+			uint32_t base;
+			uint32_t current;
+			bool collapsed;
+		};
+
+		void clearEdits();
+		void ensureIndexed() const;
+		void splitEdits(int64_t position);
+		void mergeEdits();
+
+		int64_t mapForward(uint32_t base) const;
+		int64_t mapBackward(uint32_t position) const;
+
+		template <class Visit>
+		void query(int64_t st, int64_t en, Visit visit) const;
+
+		mutable std::vector<uint32_t> starts;
+		mutable std::vector<uint32_t> ends;
+		mutable std::vector<uint32_t> maxEnds;
+		mutable std::vector<uint64_t> ids;
+		mutable int rootLevel = -1;
+		mutable bool indexed = true;
+
+		std::vector<EditSegment> edits;
+	};
+
+}
@@ -0,0 +1,319 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKRangeSet.h"
+
+#ifdef DKGEOMETRY_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace DKGeometry;
+
+
+#ifdef DKGEOMETRY_SSE2
+
+// unsigned 32-bit compares and min/max built from the signed SSE2 ones
+static inline __m128i maxU32(__m128i a, __m128i b, __m128i bias)
+{
+	__m128i greater = _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+	return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+}
+
+static inline __m128i minU32(__m128i a, __m128i b, __m128i bias)
+{
+	__m128i greater = _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+	return _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a));
+}
+
+// intersects four ranges held as separate start and length vectors and stores them interleaved
+static inline void intersect4(__m128i startA, __m128i lengthA, __m128i startB, __m128i lengthB, DRange*out)
+{
+	const __m128i bias = _mm_set1_epi32((int)0x80000000);
+	const __m128i invalid = _mm_set1_epi32(DRANGE_INVALID);
+
+	__m128i newStart = maxU32(startA, startB, bias);
+	// limits saturate at UINT32_MAX like DRange::limit
+	const __m128i ones = _mm_set1_epi32(-1);
+	__m128i limitA = _mm_add_epi32(startA, minU32(lengthA, _mm_xor_si128(startA, ones), bias));
+	__m128i limitB = _mm_add_epi32(startB, minU32(lengthB, _mm_xor_si128(startB, ones), bias));
+	__m128i newLimit = minU32(limitA, limitB, bias);
+
+	// empty inputs have limit == start, which can never pass this test
+	__m128i valid = _mm_cmpgt_epi32(_mm_xor_si128(newLimit, bias), _mm_xor_si128(newStart, bias));
+	__m128i start = _mm_or_si128(_mm_and_si128(valid, newStart), _mm_andnot_si128(valid, invalid));
+	__m128i length = _mm_and_si128(valid, _mm_sub_epi32(newLimit, newStart));
+
+	_mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi32(start, length));
+	_mm_storeu_si128((__m128i*)(out + 2), _mm_unpackhi_epi32(start, length));
+}
+
+// splits four interleaved {start, length} pairs into a start vector and a length vector
+static inline void load4(const DRange*ranges, __m128i&starts, __m128i&lengths)
+{
+	__m128 low = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)ranges));
+	__m128 high = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(ranges + 2)));
+	starts = _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+	lengths = _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+#endif // DKGEOMETRY_SSE2
+
+void DKGeometry::IntersectRanges(const DRange * a, const DRange * b, DRange * out, size_t count)
+{
+	size_t i = 0;
+#ifdef DKGEOMETRY_SSE2
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i startA, lengthA, startB, lengthB;
+		load4(a + i, startA, lengthA);
+		load4(b + i, startB, lengthB);
+		intersect4(startA, lengthA, startB, lengthB, out + i);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		out[i] = a[i].intersect(b[i]);
+	}
+}
+
+void DKGeometry::IntersectRanges(const DRange * ranges, size_t count, const DRange & with, DRange * out)
+{
+	size_t i = 0;
+#ifdef DKGEOMETRY_SSE2
+	__m128i startB = _mm_set1_epi32((int)with.start);
+	__m128i lengthB = _mm_set1_epi32((int)with.length);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i startA, lengthA;
+		load4(ranges + i, startA, lengthA);
+		intersect4(startA, lengthA, startB, lengthB, out + i);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		out[i] = ranges[i].intersect(with);
+	}
+}
+
+
+void DKGeometry::DRangeSet::assign(const DRange * source, size_t count)
+{
+	ranges.clear();
+	ranges.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (source[i].length) ranges.push_back(source[i]);
+	}
+	if (ranges.empty()) return;
+
+	std::sort(ranges.begin(), ranges.end(), [](const DRange&a, const DRange&b) {
+		return a.start < b.start;
+	});
+
+	// coalesce in place
+	std::vector<DRange> sorted;
+	sorted.swap(ranges);
+	ranges.reserve(sorted.size());
+	for (const auto&eachRange : sorted)
+	{
+		append(eachRange.start, eachRange.limit());
+	}
+}
+
+void DKGeometry::DRangeSet::append(uint32_t start, uint32_t limit)
+{
+	if (limit <= start) return;
+
+	if (!ranges.empty())
+	{
+		DRange&last = ranges.back();
+		if (start <= last.limit())
+		{
+			if (limit > last.limit()) last.length = limit - last.start;
+			return;
+		}
+	}
+	ranges.push_back(DRange(start, limit - start));
+}
+
+size_t DKGeometry::DRangeSet::lowerIndex(uint32_t position) const
+{
+	auto it = std::lower_bound(ranges.begin(), ranges.end(), position, [](const DRange&range, uint32_t value) {
+		return range.limit() < value;
+	});
+	return it - ranges.begin();
+}
+
+size_t DKGeometry::DRangeSet::upperIndex(uint32_t position) const
+{
+	auto it = std::upper_bound(ranges.begin(), ranges.end(), position, [](uint32_t value, const DRange&range) {
+		return value < range.limit();
+	});
+	return it - ranges.begin();
+}
+
+void DKGeometry::DRangeSet::add(const DRange & range)
+{
+	if (range.length == 0) return;
+
+	// ranges touching [start, limit] merge into one
+	uint32_t start = range.start;
+	uint32_t limit = range.limit();
+	size_t first = lowerIndex(start);
+	size_t last = first;
+	while (last < ranges.size() && ranges[last].start <= limit)
+	{
+		start = (std::min)(start, ranges[last].start);
+		limit = (std::max)(limit, ranges[last].limit());
+		last++;
+	}
+
+	if (first == last) {
+		ranges.insert(ranges.begin() + first, DRange(start, limit - start));
+	}
+	else {
+		ranges[first] = DRange(start, limit - start);
+		ranges.erase(ranges.begin() + first + 1, ranges.begin() + last);
+	}
+}
+
+void DKGeometry::DRangeSet::remove(const DRange & range)
+{
+	if (range.length == 0) return;
+
+	uint32_t start = range.start;
+	uint32_t limit = range.limit();
+	size_t first = upperIndex(start);
+	size_t last = first;
+	while (last < ranges.size() && ranges[last].start < limit) last++;
+	if (first == last) return;
+
+	// keep the pieces of the first and last overlapped ranges that stick out
+	DRange head = ranges[first];
+	DRange tail = ranges[last - 1];
+	std::vector<DRange> pieces;
+	if (head.start < start) pieces.push_back(DRange(head.start, start - head.start));
+	if (tail.limit() > limit) pieces.push_back(DRange(limit, tail.limit() - limit));
+
+	ranges.erase(ranges.begin() + first, ranges.begin() + last);
+	ranges.insert(ranges.begin() + first, pieces.begin(), pieces.end());
+}
+
+uint64_t DKGeometry::DRangeSet::coverage() const
+{
+	uint64_t total = 0;
+	for (const auto&eachRange : ranges) total += eachRange.length;
+	return total;
+}
+
+DRange DKGeometry::DRangeSet::bounds() const
+{
+	if (ranges.empty()) return ZeroRange();
+	return DRange(ranges.front().start, ranges.back().limit() - ranges.front().start);
+}
+
+bool DKGeometry::DRangeSet::contains(uint32_t position) const
+{
+	size_t index = upperIndex(position);
+	return index < ranges.size() && ranges[index].start <= position;
+}
+
+bool DKGeometry::DRangeSet::contains(const DRange & range) const
+{
+	if (range.length == 0) return false;
+	size_t index = upperIndex(range.start);
+	return index < ranges.size() && ranges[index].start <= range.start && ranges[index].limit() >= range.limit();
+}
+
+bool DKGeometry::DRangeSet::intersects(const DRange & range) const
+{
+	if (range.length == 0) return false;
+	size_t index = upperIndex(range.start);
+	return index < ranges.size() && ranges[index].start < range.limit();
+}
+
+DRangeSet DKGeometry::DRangeSet::unite(const DRangeSet & set) const
+{
+	DRangeSet result;
+	result.ranges.reserve(ranges.size() + set.ranges.size());
+
+	size_t i = 0, j = 0;
+	while (i < ranges.size() || j < set.ranges.size())
+	{
+		const DRange&next = (j == set.ranges.size() || (i < ranges.size() && ranges[i].start <= set.ranges[j].start)) ?
+			ranges[i++] : set.ranges[j++];
+		result.append(next.start, next.limit());
+	}
+	return result;
+}
+
+DRangeSet DKGeometry::DRangeSet::intersect(const DRangeSet & set) const
+{
+	DRangeSet result;
+
+	size_t i = 0, j = 0;
+	while (i < ranges.size() && j < set.ranges.size())
+	{
+		const DRange&a = ranges[i];
+		const DRange&b = set.ranges[j];
+		uint32_t start = (std::max)(a.start, b.start);
+		uint32_t limit = (std::min)(a.limit(), b.limit());
+		if (start < limit) result.ranges.push_back(DRange(start, limit - start));
+
+		if (a.limit() < b.limit()) i++;
+		else j++;
+	}
+	return result;
+}
+
+DRangeSet DKGeometry::DRangeSet::subtract(const DRangeSet & set) const
+{
+	DRangeSet result;
+	result.ranges.reserve(ranges.size());
+
+	size_t j = 0;
+	for (const auto&eachRange : ranges)
+	{
+		uint32_t start = eachRange.start;
+		uint32_t limit = eachRange.limit();
+
+		while (j < set.ranges.size() && set.ranges[j].limit() <= start) j++;
+
+		size_t k = j;
+		while (k < set.ranges.size() && set.ranges[k].start < limit)
+		{
+			if (set.ranges[k].start > start)
+				result.ranges.push_back(DRange(start, set.ranges[k].start - start));
+			start = (std::max)(start, set.ranges[k].limit());
+			if (start >= limit) break;
+			k++;
+		}
+		if (start < limit) result.ranges.push_back(DRange(start, limit - start));
+	}
+	return result;
+}
@@ -0,0 +1,95 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+#include "DKGeometry.h"
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Pairwise intersection of two DRange arrays, out[i] = a[i].intersect(b[i]).
+	/// Empty or disjoint pairs produce DRange(DRANGE_INVALID, 0), as the scalar
+	/// version does. Uses SSE2 when available.</summary>
+	void IntersectRanges(const DRange*a, const DRange*b, DRange*out, size_t count);
+
+	/// <summary>
+	/// Intersects every range in the array with a single range.</summary>
+	void IntersectRanges(const DRange*ranges, size_t count, const DRange&with, DRange*out);
+
+	/// <summary>
+	/// Sorted set of disjoint, non-touching, non-empty ranges.
+	/// Overlapping or adjacent ranges are coalesced on insert, empty ranges
+	/// are ignored, and the set operations are linear merges.</summary>
+	class DRangeSet
+	{
+	public:
+		DRangeSet() {}
+		DRangeSet(const DRange*ranges, size_t count) { assign(ranges, count); }
+		DRangeSet(const std::vector<DRange>&ranges) { assign(ranges.data(), ranges.size()); }
+
+		// sorts and coalesces an arbitrary list of ranges
+		void assign(const DRange*ranges, size_t count);
+
+		void add(const DRange&range);
+		void remove(const DRange&range);
+		inline void clear() { ranges.clear(); }
+
+		inline size_t size() const { return ranges.size(); }
+		inline bool isEmpty() const { return ranges.empty(); }
+		inline const std::vector<DRange>& getRanges() const { return ranges; }
+		inline const DRange& operator[](size_t index) const { return ranges[index]; }
+		inline std::vector<DRange>::const_iterator begin() const { return ranges.begin(); }
+		inline std::vector<DRange>::const_iterator end() const { return ranges.end(); }
+
+		// number of positions covered
+		uint64_t coverage() const;
+		// smallest range covering the whole set
+		DRange bounds() const;
+
+		bool contains(uint32_t position) const;
+		bool contains(const DRange&range) const;
+		bool intersects(const DRange&range) const;
+
+		DRangeSet unite(const DRangeSet&set) const;
+		DRangeSet intersect(const DRangeSet&set) const;
+		DRangeSet subtract(const DRangeSet&set) const;
+
+		inline DRangeSet operator|(const DRangeSet&set) const { return unite(set); }
+		inline DRangeSet operator&(const DRangeSet&set) const { return intersect(set); }
+		inline DRangeSet operator-(const DRangeSet&set) const { return subtract(set); }
+
+		inline bool operator==(const DRangeSet&set) const { return ranges == set.ranges; }
+		inline bool operator!=(const DRangeSet&set) const { return ranges != set.ranges; }
+
+	private:
+		// index of the first range whose limit reaches position
+		size_t lowerIndex(uint32_t position) const;
+		// index of the first range whose limit passes position
+		size_t upperIndex(uint32_t position) const;
+		void append(uint32_t start, uint32_t limit);
+
+		std::vector<DRange> ranges;
+	};
+
+}
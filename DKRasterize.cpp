@@ -0,0 +1,303 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+
+#include "DKRasterize.h"
+
+#include <math.h>
+#include <string.h>
+
+#ifdef DKGEOMETRY_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace DKGeometry;
+
+
+namespace
+{
+	const uint32_t BandRows = 32;
+	const size_t BoxGrain = 16384;
+
+	// covered pixels x0 .. x1 - 1, y0 .. y1 - 1
+	struct PixelBox
+	{
+		uint32_t x0, y0, x1, y1;
+
+		inline bool isEmpty() const { return x0 >= x1 || y0 >= y1; }
+	};
+
+	struct PixelGrid
+	{
+		DRect area;
+		DRect clip;
+		bool clipped;
+		double scaleX;
+		double scaleY;
+		uint32_t width;
+		uint32_t height;
+	};
+
+	// first pixel whose center is at or past position, in pixel units
+	inline uint32_t firstPixel(double position, uint32_t limit)
+	{
+		double pixel = ceil(position - 0.5);
+		if (!(pixel > 0)) return 0;
+		if (pixel >= limit) return limit;
+		return (uint32_t)pixel;
+	}
+
+	inline PixelBox boxOf(const DRect&source, const PixelGrid&grid)
+	{
+		DRect rect(source);
+		rect.Normalize();
+		if (grid.clipped)
+		{
+			rect.left = (std::max)(rect.left, grid.clip.left);
+			rect.top = (std::max)(rect.top, grid.clip.top);
+			rect.right = (std::min)(rect.right, grid.clip.right);
+			rect.bottom = (std::min)(rect.bottom, grid.clip.bottom);
+		}
+
+		PixelBox box;
+		box.x0 = firstPixel(((double)rect.left - grid.area.left) * grid.scaleX, grid.width);
+		box.x1 = firstPixel(((double)rect.right - grid.area.left) * grid.scaleX, grid.width);
+		box.y0 = firstPixel(((double)rect.top - grid.area.top) * grid.scaleY, grid.height);
+		box.y1 = firstPixel(((double)rect.bottom - grid.area.top) * grid.scaleY, grid.height);
+		return box;
+	}
+
+	inline bool makeGrid(const DRect&area, uint32_t width, uint32_t height, const DRect*clip, PixelGrid&grid)
+	{
+		grid.area = area;
+		grid.area.Normalize();
+		grid.clipped = clip != nullptr;
+		if (clip)
+		{
+			grid.clip = *clip;
+			grid.clip.Normalize();
+		}
+		grid.width = width;
+		grid.height = height;
+		grid.scaleX = grid.area.Width() > 0 ? width / (double)grid.area.Width() : 0;
+		grid.scaleY = grid.area.Height() > 0 ? height / (double)grid.area.Height() : 0;
+		return width && height && grid.scaleX > 0 && grid.scaleY > 0;
+	}
+
+	// Pixel boxes of every rect, plus the boxes touching each band of
+	// BandRows rows: band b holds items[bandOffsets[b]] .. items[bandOffsets[b + 1] - 1].
+	struct Bands
+	{
+		uint32_t count = 0;
+		std::vector<PixelBox> boxes;
+		std::vector<uint32_t> bandOffsets;
+		std::vector<uint32_t> items;
+	};
+
+	void bucketBands(const DRectArray&rects, const PixelGrid&grid, Bands&bands, DExecutor&executor)
+	{
+		size_t count = rects.size();
+		bands.count = (grid.height + BandRows - 1) / BandRows;
+		bands.boxes.resize(count);
+		executor.parallelFor(count, BoxGrain, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) bands.boxes[i] = boxOf(rects[i], grid);
+		});
+
+		bands.bandOffsets.assign(bands.count + 1, 0);
+		for (const auto&box : bands.boxes)
+		{
+			if (box.isEmpty()) continue;
+			for (uint32_t b = box.y0 / BandRows, last = (box.y1 - 1) / BandRows; b <= last; b++)
+				bands.bandOffsets[b + 1]++;
+		}
+		for (uint32_t b = 0; b < bands.count; b++) bands.bandOffsets[b + 1] += bands.bandOffsets[b];
+
+		bands.items.resize(bands.bandOffsets[bands.count]);
+		std::vector<uint32_t> cursor(bands.bandOffsets.begin(), bands.bandOffsets.end() - 1);
+		for (size_t i = 0; i < count; i++)
+		{
+			const PixelBox&box = bands.boxes[i];
+			if (box.isEmpty()) continue;
+			for (uint32_t b = box.y0 / BandRows, last = (box.y1 - 1) / BandRows; b <= last; b++)
+				bands.items[cursor[b]++] = (uint32_t)i;
+		}
+	}
+
+	inline void fillBits(uint8_t*row, uint32_t x0, uint32_t x1)
+	{
+		uint32_t first = x0 >> 3;
+		uint32_t last = (x1 - 1) >> 3;
+		uint8_t firstMask = (uint8_t)(0xFF << (x0 & 7));
+		uint8_t lastMask = (uint8_t)(0xFF >> (7 - ((x1 - 1) & 7)));
+		if (first == last)
+		{
+			row[first] |= firstMask & lastMask;
+			return;
+		}
+		row[first] |= firstMask;
+		memset(row + first + 1, 0xFF, last - first - 1);
+		row[last] |= lastMask;
+	}
+
+	// first pixel at or after from whose bit is value, or width
+	inline uint32_t nextBit(const uint8_t*row, uint32_t from, uint32_t width, bool value)
+	{
+		uint8_t skip = value ? 0x00 : 0xFF;
+		uint32_t x = from;
+		while (x < width)
+		{
+			uint8_t byte = row[x >> 3];
+			if ((x & 7) == 0 && byte == skip) {
+				x += 8;
+				continue;
+			}
+			if ((bool)((byte >> (x & 7)) & 1) == value) return x;
+			x++;
+		}
+		return width;
+	}
+
+	inline void addCounts(uint8_t*pixels, uint32_t count)
+	{
+#ifdef DKGEOMETRY_SSE2
+		const __m128i one = _mm_set1_epi8(1);
+		for (; count >= 16; count -= 16, pixels += 16)
+		{
+			__m128i value = _mm_loadu_si128((const __m128i*)pixels);
+			_mm_storeu_si128((__m128i*)pixels, _mm_adds_epu8(value, one));
+		}
+#endif
+		for (; count; count--, pixels++)
+		{
+			if (*pixels != 0xFF) (*pixels)++;
+		}
+	}
+}
+
+
+void DKGeometry::RasterizeRects(const DRectArray & rects, const DRect & area, uint32_t width, uint32_t height,
+	DCoverageFormat format, DCoverageMask & mask, const DRect * clip, DExecutor & executor)
+{
+	PixelGrid grid;
+	bool drawable = makeGrid(area, width, height, clip, grid);
+
+	mask.area = grid.area;
+	mask.width = width;
+	mask.height = height;
+	mask.format = format;
+	mask.stride = (format == DCoverageBits) ? (width + 7) / 8 : width;
+	mask.data.assign(mask.stride * height, 0);
+	if (!drawable || rects.empty()) return;
+
+	Bands bands;
+	bucketBands(rects, grid, bands, executor);
+
+	// bands own disjoint rows, so they fill without synchronization
+	executor.parallelFor(bands.count, 1, [&](size_t begin, size_t end) {
+		for (size_t b = begin; b < end; b++)
+		{
+			uint32_t bandTop = (uint32_t)b * BandRows;
+			uint32_t bandBottom = (std::min)(bandTop + BandRows, height);
+			for (uint32_t k = bands.bandOffsets[b]; k < bands.bandOffsets[b + 1]; k++)
+			{
+				const PixelBox&box = bands.boxes[bands.items[k]];
+				uint32_t y0 = (std::max)(box.y0, bandTop);
+				uint32_t y1 = (std::min)(box.y1, bandBottom);
+				for (uint32_t y = y0; y < y1; y++)
+				{
+					if (format == DCoverageBits) fillBits(mask.row(y), box.x0, box.x1);
+					else addCounts(mask.row(y) + box.x0, box.x1 - box.x0);
+				}
+			}
+		}
+	});
+}
+
+void DKGeometry::RasterizeSpans(const DRectArray & rects, const DRect & area, uint32_t width, uint32_t height,
+	DScanlineSpans & spans, const DRect * clip, DExecutor & executor)
+{
+	PixelGrid grid;
+	bool drawable = makeGrid(area, width, height, clip, grid);
+
+	spans.area = grid.area;
+	spans.width = width;
+	spans.height = height;
+	spans.offsets.assign((size_t)height + 1, 0);
+	spans.spans.clear();
+	if (!drawable || rects.empty()) return;
+
+	Bands bands;
+	bucketBands(rects, grid, bands, executor);
+
+	// each band rasterizes its rows into a local bit mask and reads the runs
+	// back, which costs the same whether a row has two rects or two thousand
+	size_t stride = (width + 7) / 8;
+	std::vector<std::vector<DSpan>> bandSpans(bands.count);
+	std::vector<uint32_t> rowCounts(height, 0);
+	executor.parallelFor(bands.count, 1, [&](size_t begin, size_t end) {
+		std::vector<uint8_t> bits;
+		for (size_t b = begin; b < end; b++)
+		{
+			uint32_t bandTop = (uint32_t)b * BandRows;
+			uint32_t bandBottom = (std::min)(bandTop + BandRows, height);
+
+			bits.assign(stride * (bandBottom - bandTop), 0);
+			for (uint32_t k = bands.bandOffsets[b]; k < bands.bandOffsets[b + 1]; k++)
+			{
+				const PixelBox&box = bands.boxes[bands.items[k]];
+				uint32_t y0 = (std::max)(box.y0, bandTop);
+				uint32_t y1 = (std::min)(box.y1, bandBottom);
+				for (uint32_t y = y0; y < y1; y++) fillBits(bits.data() + (y - bandTop) * stride, box.x0, box.x1);
+			}
+
+			std::vector<DSpan>&local = bandSpans[b];
+			for (uint32_t y = bandTop; y < bandBottom; y++)
+			{
+				const uint8_t*row = bits.data() + (y - bandTop) * stride;
+				size_t first = local.size();
+				for (uint32_t x = nextBit(row, 0, width, true); x < width; )
+				{
+					uint32_t runEnd = nextBit(row, x, width, false);
+					local.push_back({ x, runEnd });
+					x = nextBit(row, runEnd, width, true);
+				}
+				rowCounts[y] = (uint32_t)(local.size() - first);
+			}
+		}
+	});
+
+	for (uint32_t y = 0; y < height; y++) spans.offsets[y + 1] = spans.offsets[y] + rowCounts[y];
+	spans.spans.resize(spans.offsets[height]);
+	executor.parallelFor(bands.count, 1, [&](size_t begin, size_t end) {
+		for (size_t b = begin; b < end; b++)
+		{
+			if (bandSpans[b].empty()) continue;
+			memcpy(spans.spans.data() + spans.offsets[b * BandRows], bandSpans[b].data(), bandSpans[b].size() * sizeof(DSpan));
+		}
+	});
+}
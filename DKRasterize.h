@@ -0,0 +1,100 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKThreadPool.h"
+
+namespace DKGeometry
+{
+	enum DCoverageFormat
+	{
+		DCoverageBits,	// 1 bit per pixel, set when any rect covers it (lsb first)
+		DCoverageCounts	// 1 byte per pixel, rects covering it, saturating at 255
+	};
+
+	/// <summary>
+	/// Coverage of area sampled on a width x height pixel grid. Rows are
+	/// stride bytes apart, top row first.</summary>
+	struct DCoverageMask
+	{
+		DRect area;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		DCoverageFormat format = DCoverageBits;
+		size_t stride = 0;
+		std::vector<uint8_t> data;
+
+		inline const uint8_t* row(uint32_t y) const { return data.data() + y * stride; }
+		inline uint8_t* row(uint32_t y) { return data.data() + y * stride; }
+
+		// covering rect count for DCoverageCounts, 0 or 1 for DCoverageBits
+		inline uint8_t at(uint32_t x, uint32_t y) const {
+			if (format == DCoverageBits) return (row(y)[x >> 3] >> (x & 7)) & 1;
+			return row(y)[x];
+		}
+	};
+
+	// covered pixels begin .. end - 1 of one row
+	struct DSpan
+	{
+		uint32_t begin;
+		uint32_t end;
+	};
+
+	/// <summary>
+	/// Union of the covered pixels of each row as sorted, disjoint, non-touching
+	/// spans in compressed row storage: the spans of row y are
+	/// spans[offsets[y]] .. spans[offsets[y + 1] - 1].</summary>
+	struct DScanlineSpans
+	{
+		DRect area;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<uint32_t> offsets;
+		std::vector<DSpan> spans;
+
+		inline size_t spanCount(uint32_t y) const { return offsets[y + 1] - offsets[y]; }
+		inline const DSpan* rowSpans(uint32_t y) const { return spans.data() + offsets[y]; }
+	};
+
+	/// <summary>
+	/// Rasterizes rects onto a width x height grid laid over area.
+	/// A pixel is covered by a rect when its center lies inside it, left and
+	/// top edges inclusive, right and bottom exclusive, so rects sharing an
+	/// edge never cover the same pixel and empty rects cover nothing.
+	/// With clip, only the parts of the rects inside clip count.
+	/// Rects are bucketed into row bands that are filled in parallel; the
+	/// result does not depend on the executor.</summary>
+	void RasterizeRects(const DRectArray&rects, const DRect&area, uint32_t width, uint32_t height,
+		DCoverageFormat format, DCoverageMask&mask, const DRect*clip = nullptr,
+		DExecutor&executor = DefaultExecutor());
+
+	/// <summary>
+	/// Same coverage rule as RasterizeRects, as merged spans per row.</summary>
+	void RasterizeSpans(const DRectArray&rects, const DRect&area, uint32_t width, uint32_t height,
+		DScanlineSpans&spans, const DRect*clip = nullptr,
+		DExecutor&executor = DefaultExecutor());
+
+}
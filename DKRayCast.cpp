@@ -0,0 +1,147 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKRayCast.h"
+
+using namespace DKGeometry;
+
+
+namespace
+{
+	// the slab test of DRay::Intersects with the inverse direction computed once
+	struct RayProbe
+	{
+		float origin[2];
+		float inverse[2];
+		bool parallel[2];
+
+		explicit RayProbe(const DRay&ray)
+		{
+			origin[0] = ray.origin.x;
+			origin[1] = ray.origin.y;
+			parallel[0] = ray.direction.x == 0;
+			parallel[1] = ray.direction.y == 0;
+			inverse[0] = parallel[0] ? 0.f : 1.f / ray.direction.x;
+			inverse[1] = parallel[1] ? 0.f : 1.f / ray.direction.y;
+		}
+
+		// rects in the index are already normalized
+		inline bool hit(const DRect&rect, float tMax, float&tNear) const
+		{
+			float t0 = 0.f;
+			float t1 = tMax;
+			const float lows[2] = { rect.left, rect.top };
+			const float highs[2] = { rect.right, rect.bottom };
+			for (int axis = 0; axis < 2; axis++)
+			{
+				if (parallel[axis])
+				{
+					if (origin[axis] < lows[axis] || origin[axis] > highs[axis]) return false;
+					continue;
+				}
+				float ta = (lows[axis] - origin[axis]) * inverse[axis];
+				float tb = (highs[axis] - origin[axis]) * inverse[axis];
+				if (ta > tb) std::swap(ta, tb);
+				if (ta > t0) t0 = ta;
+				if (tb < t1) t1 = tb;
+				if (t0 > t1) return false;
+			}
+			tNear = t0;
+			return true;
+		}
+	};
+}
+
+DRayHit DKGeometry::RayCastFirst(const DRectIndexView & index, const DRay & ray, float maxT)
+{
+	DRayHit best;
+	if (index.isEmpty() || !index.items) return best;
+
+	RayProbe probe(ray);
+	float limit = maxT;
+	float tRoot;
+	if (!probe.hit(index.root().bounds, limit, tRoot)) return best;
+
+	// ties are broken on item position since nodes are visited by entry parameter
+	uint32_t bestIndex = UINT32_MAX;
+
+	struct Pending { size_t node; float t; };
+	Pending stack[256];
+	size_t depth = 0;
+	stack[depth++] = { index.nodeCount - 1, tRoot };
+
+	while (depth)
+	{
+		Pending current = stack[--depth];
+		if (current.t > limit) continue;
+		const DRectIndexNode&node = index.nodes[current.node];
+
+		if (current.node < index.leafCount)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; i++)
+			{
+				float t;
+				if (probe.hit(index.items[i], limit, t) && (t < best.t || (t == best.t && i < bestIndex)))
+				{
+					best.id = index.items[i].id;
+					best.t = t;
+					bestIndex = i;
+					limit = t;
+				}
+			}
+			continue;
+		}
+
+		// push the children far to near so the nearest is searched first
+		Pending children[DRectIndex::NodeSize];
+		size_t hits = 0;
+		for (uint32_t i = node.first; i < node.first + node.count; i++)
+		{
+			float t;
+			if (probe.hit(index.nodes[i].bounds, limit, t)) children[hits++] = { i, t };
+		}
+		std::sort(children, children + hits, [](const Pending&a, const Pending&b) {
+			return a.t > b.t || (a.t == b.t && a.node > b.node);
+		});
+		for (size_t i = 0; i < hits; i++) stack[depth++] = children[i];
+	}
+	return best;
+}
+
+void DKGeometry::RayCastFirst(const DRectIndexView & index, const DRay * rays, size_t count, DRayHit * hits, float maxT, DExecutor & executor)
+{
+	executor.parallelFor(count, 256, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) hits[i] = RayCastFirst(index, rays[i], maxT);
+	});
+}
+
+void DKGeometry::RayCastFirst(const IDRArray & rects, const DRay * rays, size_t count, DRayHit * hits, float maxT, DExecutor & executor)
+{
+	DRectIndex index(rects);
+	RayCastFirst(index.view(), rays, count, hits, maxT, executor);
+}
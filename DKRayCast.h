@@ -0,0 +1,56 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKRectIndex.h"
+#include "DKThreadPool.h"
+
+namespace DKGeometry
+{
+	struct DRayHit
+	{
+		uint64_t id = 0;
+		float t = DKInfinity;	// entry parameter along the ray, DKInfinity for a miss
+
+		inline bool isHit() const { return t != DKInfinity; }
+	};
+
+	/// <summary>
+	/// First rect along the ray: the smallest entry parameter in [0, maxT],
+	/// edges included, with 0 when the ray starts inside a rect. Nodes are
+	/// visited nearest first and skipped once they start past the best hit.
+	/// For a line of sight probe from a to b use DRay::fromPoints(a, b) and
+	/// maxT 1. Ties go to the rect stored first in the index.</summary>
+	DRayHit RayCastFirst(const DRectIndexView&index, const DRay&ray, float maxT = DKInfinity);
+
+	// one hit per ray, run on the executor
+	void RayCastFirst(const DRectIndexView&index, const DRay*rays, size_t count, DRayHit*hits,
+		float maxT = DKInfinity, DExecutor&executor = DefaultExecutor());
+
+	// indexes the rects first; build a DRectIndex once to cast repeatedly
+	void RayCastFirst(const IDRArray&rects, const DRay*rays, size_t count, DRayHit*hits,
+		float maxT = DKInfinity, DExecutor&executor = DefaultExecutor());
+
+}
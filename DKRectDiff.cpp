@@ -0,0 +1,203 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKRectDiff.h"
+
+#include <math.h>
+
+#ifdef DKGEOMETRY_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace DKGeometry;
+
+
+void DKGeometry::DRectDiff::clear()
+{
+	added.clear();
+	removed.clear();
+	moved.clear();
+	resized.clear();
+}
+
+namespace
+{
+	const size_t DiffGrain = 16384;
+	const uint32_t NoMatch = UINT32_MAX;
+
+	enum Change { ChangeMoved = 1, ChangeResized = 2 };
+
+	// which of left, top, width and height differ
+	inline int compareRects(const DRect&a, const DRect&b, float epsilon)
+	{
+#ifdef DKGEOMETRY_SSE2
+		// (left, top, right, bottom) -> (left, top, width, height)
+		__m128 va = _mm_loadu_ps(&a.left);
+		__m128 vb = _mm_loadu_ps(&b.left);
+		const __m128 sizeLanes = _mm_castsi128_ps(_mm_set_epi32(-1, -1, 0, 0));
+		va = _mm_or_ps(_mm_andnot_ps(sizeLanes, va), _mm_and_ps(sizeLanes, _mm_sub_ps(va, _mm_movelh_ps(va, va))));
+		vb = _mm_or_ps(_mm_andnot_ps(sizeLanes, vb), _mm_and_ps(sizeLanes, _mm_sub_ps(vb, _mm_movelh_ps(vb, vb))));
+
+		__m128 changed;
+		if (epsilon > 0)
+		{
+			const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+			__m128 distance = _mm_and_ps(_mm_sub_ps(va, vb), absMask);
+			changed = _mm_cmpnlt_ps(distance, _mm_set1_ps(epsilon));
+		}
+		else
+		{
+			changed = _mm_cmpneq_ps(va, vb);
+		}
+		int mask = _mm_movemask_ps(changed);
+		return ((mask & 3) ? ChangeMoved : 0) | ((mask & 12) ? ChangeResized : 0);
+#else
+		auto differs = [epsilon](float x, float y) {
+			return epsilon > 0 ? fCompare(x, y, epsilon) != 0 : !(x == y);
+		};
+		int result = 0;
+		if (differs(a.left, b.left) || differs(a.top, b.top)) result |= ChangeMoved;
+		if (differs(a.Width(), b.Width()) || differs(a.Height(), b.Height())) result |= ChangeResized;
+		return result;
+#endif
+	}
+
+	inline uint64_t hashId(uint64_t id)
+	{
+		return id * 0x9E3779B97F4A7C15ull;
+	}
+
+	// open addressing table from id to position in the old snapshot
+	class IdTable
+	{
+	public:
+		explicit IdTable(const IDRArray&rects)
+		{
+			size_t capacity = 16;
+			while (capacity < rects.size() * 2) capacity <<= 1;
+			shift = 64;
+			for (size_t c = capacity; c > 1; c >>= 1) shift--;
+			mask = capacity - 1;
+			slots.assign(capacity, NoMatch);
+
+			for (uint32_t i = 0; i < (uint32_t)rects.size(); i++)
+			{
+				size_t slot = (size_t)(hashId(rects[i].id) >> shift);
+				while (slots[slot] != NoMatch)
+				{
+					// keep the first occurrence of a duplicate id
+					if (rects[slots[slot]].id == rects[i].id) break;
+					slot = (slot + 1) & mask;
+				}
+				if (slots[slot] == NoMatch) slots[slot] = i;
+			}
+		}
+
+		inline uint32_t find(const IDRArray&rects, uint64_t id) const
+		{
+			size_t slot = (size_t)(hashId(id) >> shift);
+			for (;;)
+			{
+				uint32_t index = slots[slot];
+				if (index == NoMatch || rects[index].id == id) return index;
+				slot = (slot + 1) & mask;
+			}
+		}
+
+	private:
+		std::vector<uint32_t> slots;
+		size_t mask;
+		int shift;
+	};
+
+	bool sortedById(const IDRArray&rects)
+	{
+		for (size_t i = 1; i < rects.size(); i++)
+		{
+			if (rects[i].id <= rects[i - 1].id) return false;
+		}
+		return true;
+	}
+}
+
+void DKGeometry::DiffRects(const IDRArray & before, const IDRArray & after, DRectDiff & diff, float epsilon, DExecutor & executor)
+{
+	diff.clear();
+
+	// match[i] is the old position of after[i], or NoMatch
+	std::vector<uint32_t> match(after.size(), NoMatch);
+	std::vector<uint8_t> matched(before.size(), 0);
+
+	if (sortedById(before) && sortedById(after))
+	{
+		size_t i = 0, j = 0;
+		while (i < before.size() && j < after.size())
+		{
+			if (before[i].id < after[j].id) i++;
+			else if (after[j].id < before[i].id) j++;
+			else {
+				match[j++] = (uint32_t)i;
+				matched[i++] = 1;
+			}
+		}
+	}
+	else
+	{
+		IdTable table(before);
+		executor.parallelFor(after.size(), DiffGrain, [&](size_t begin, size_t end) {
+			for (size_t j = begin; j < end; j++) match[j] = table.find(before, after[j].id);
+		});
+		// marked serially, duplicate ids in after would otherwise race
+		for (uint32_t eachMatch : match)
+		{
+			if (eachMatch != NoMatch) matched[eachMatch] = 1;
+		}
+	}
+
+	std::vector<uint8_t> changes(after.size(), 0);
+	executor.parallelFor(after.size(), DiffGrain, [&](size_t begin, size_t end) {
+		for (size_t j = begin; j < end; j++)
+		{
+			if (match[j] != NoMatch) changes[j] = (uint8_t)compareRects(before[match[j]], after[j], epsilon);
+		}
+	});
+
+	for (size_t j = 0; j < after.size(); j++)
+	{
+		if (match[j] == NoMatch) {
+			diff.added.push_back(after[j].id);
+			continue;
+		}
+		if (changes[j] & ChangeMoved) diff.moved.push_back(after[j].id);
+		if (changes[j] & ChangeResized) diff.resized.push_back(after[j].id);
+	}
+	for (size_t i = 0; i < before.size(); i++)
+	{
+		if (!matched[i]) diff.removed.push_back(before[i].id);
+	}
+}
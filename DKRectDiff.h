@@ -0,0 +1,56 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKThreadPool.h"
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Changes between two snapshots, matched by IDRect::id.
+	/// moved lists ids whose left or top changed, resized those whose width or
+	/// height changed; an id can be in both. added and moved/resized follow the
+	/// order of the new snapshot, removed the order of the old one.</summary>
+	struct DRectDiff
+	{
+		std::vector<uint64_t> added;
+		std::vector<uint64_t> removed;
+		std::vector<uint64_t> moved;
+		std::vector<uint64_t> resized;
+
+		inline bool isEmpty() const { return added.empty() && removed.empty() && moved.empty() && resized.empty(); }
+		void clear();
+	};
+
+	/// <summary>
+	/// Diffs two snapshots with unique ids. When both are sorted by id they are
+	/// merged in one pass, otherwise the old snapshot is hashed and the new one
+	/// probed in parallel. Matched rects are compared four coordinates at a
+	/// time; with epsilon > 0 a coordinate only counts as changed when
+	/// fCompare(old, new, epsilon) would say so, with 0 any difference counts.</summary>
+	void DiffRects(const IDRArray&before, const IDRArray&after, DRectDiff&diff,
+		float epsilon = 0.f, DExecutor&executor = DefaultExecutor());
+
+}
@@ -0,0 +1,138 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKRectIndex.h"
+
+#include <math.h>
+
+using namespace DKGeometry;
+
+
+size_t DKGeometry::DRectIndexView::Count(const DRect & area) const
+{
+	size_t count = 0;
+	Visit(area, [&count](const IDRect&) {
+		count++;
+		return true;
+	});
+	return count;
+}
+
+
+void DKGeometry::DRectIndex::Build(const IDRArray & rects)
+{
+	items = rects;
+	for (auto&eachItem : items)
+	{
+		eachItem.Normalize();
+	}
+
+	// sort-tile-recursive: vertical slices by center x, each slice sorted by center y
+	size_t count = items.size();
+	size_t leaves = (count + NodeSize - 1) / NodeSize;
+	size_t slices = (size_t)ceil(sqrt((double)leaves));
+	size_t sliceSize = (slices ? (leaves + slices - 1) / slices : 1) * NodeSize;
+
+	auto centerX = [](const IDRect&a, const IDRect&b) { return a.left + a.right < b.left + b.right; };
+	auto centerY = [](const IDRect&a, const IDRect&b) { return a.top + a.bottom < b.top + b.bottom; };
+
+	std::sort(items.begin(), items.end(), centerX);
+	for (size_t first = 0; first < count; first += sliceSize)
+	{
+		size_t last = (std::min)(first + sliceSize, count);
+		std::sort(items.begin() + first, items.begin() + last, centerY);
+	}
+
+	buildNodes();
+}
+
+void DKGeometry::DRectIndex::Build(const DRectArray & rects)
+{
+	IDRArray withIds;
+	withIds.reserve(rects.size());
+	for (size_t i = 0; i < rects.size(); i++)
+	{
+		withIds.push_back(IDRect(rects[i], i));
+	}
+	Build(withIds);
+}
+
+void DKGeometry::DRectIndex::clear()
+{
+	items.clear();
+	nodes.clear();
+	leafCount = 0;
+}
+
+void DKGeometry::DRectIndex::buildNodes()
+{
+	nodes.clear();
+	leafCount = 0;
+	size_t count = items.size();
+	if (count == 0) return;
+
+	size_t total = 0;
+	for (size_t level = count; ; level = (level + NodeSize - 1) / NodeSize)
+	{
+		total += (level + NodeSize - 1) / NodeSize;
+		if (level <= NodeSize) break;
+	}
+	nodes.reserve(total);
+
+	// leaves over the items
+	for (size_t first = 0; first < count; first += NodeSize)
+	{
+		uint32_t childCount = (uint32_t)(std::min)((size_t)NodeSize, count - first);
+		DRect bounds = items[first];
+		for (size_t i = first + 1; i < first + childCount; i++)
+		{
+			bounds.CombineWith(items[i]);
+		}
+		nodes.push_back({ bounds, (uint32_t)first, childCount });
+	}
+	leafCount = nodes.size();
+
+	// parents over the previous level until a single root remains
+	size_t levelStart = 0;
+	size_t levelEnd = nodes.size();
+	while (levelEnd - levelStart > 1)
+	{
+		for (size_t first = levelStart; first < levelEnd; first += NodeSize)
+		{
+			uint32_t childCount = (uint32_t)(std::min)((size_t)NodeSize, levelEnd - first);
+			DRect bounds = nodes[first].bounds;
+			for (size_t i = first + 1; i < first + childCount; i++)
+			{
+				bounds.CombineWith(nodes[i].bounds);
+			}
+			nodes.push_back({ bounds, (uint32_t)first, childCount });
+		}
+		levelStart = levelEnd;
+		levelEnd = nodes.size();
+	}
+}
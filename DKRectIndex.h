@@ -0,0 +1,180 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKGeometry.h"
+
+namespace DKGeometry
+{
+	// one node of a packed R-tree; leaves reference items, the rest reference child nodes
+	struct DRectIndexNode
+	{
+		DRect bounds;
+		uint32_t first;
+		uint32_t count;
+	};
+
+	/// <summary>
+	/// Non-owning view over a packed R-tree. Nodes are stored level by level,
+	/// leaves first and the root last, so the same queries run over an owned
+	/// DRectIndex or over pages mapped straight from a snapshot file.</summary>
+	struct DRectIndexView
+	{
+		const DRectIndexNode* nodes = nullptr;
+		size_t nodeCount = 0;
+		size_t leafCount = 0;		// nodes [0, leafCount) reference items
+		const IDRect* items = nullptr;	// may be null when the items live elsewhere
+		size_t itemCount = 0;
+
+		inline bool isEmpty() const { return nodeCount == 0; }
+		inline const DRectIndexNode& root() const { return nodes[nodeCount - 1]; }
+		inline DRect bounds() const { return isEmpty() ? DRect() : root().bounds; }
+
+		/// <summary>
+		/// Calls visit(first, count) for every leaf whose bounds touch area.
+		/// Returning false from visit stops the search.</summary>
+		template <class LeafVisitor>
+		void VisitLeaves(const DRect&area, LeafVisitor visit) const
+		{
+			if (isEmpty()) return;
+
+			DRect query(area);
+			query.Normalize();
+			if (!touches(root().bounds, query)) return;
+
+			// enough for 16-way nodes over any 32-bit item count
+			size_t stack[256];
+			size_t depth = 0;
+			stack[depth++] = nodeCount - 1;
+			while (depth)
+			{
+				size_t index = stack[--depth];
+				const DRectIndexNode&node = nodes[index];
+				if (index < leafCount) {
+					if (!visit(node.first, node.count)) return;
+					continue;
+				}
+				for (uint32_t i = node.first + node.count; i-- > node.first; )
+				{
+					if (touches(nodes[i].bounds, query)) stack[depth++] = i;
+				}
+			}
+		}
+
+		/// <summary>
+		/// Calls visit(item) for every item that intersects area, with the
+		/// same inclusive edges as DRect::Intersects. Finds nothing when the
+		/// view has no items.</summary>
+		template <class ItemVisitor>
+		void Visit(const DRect&area, ItemVisitor visit) const
+		{
+			if (!items) return;
+
+			DRect query(area);
+			query.Normalize();
+			VisitLeaves(query, [this, &query, &visit](uint32_t first, uint32_t count) {
+				for (uint32_t i = first; i < first + count; i++)
+				{
+					if (touches(items[i], query) && !visit(items[i])) return false;
+				}
+				return true;
+			});
+		}
+
+		// appends matches; works with any allocator, including pmr::IDRArray
+		template <class Alloc>
+		void Search(const DRect&area, std::vector<IDRect, Alloc>&results) const
+		{
+			Visit(area, [&results](const IDRect&item) {
+				results.push_back(item);
+				return true;
+			});
+		}
+
+		template <class Alloc>
+		void Search(const DRect&area, std::vector<uint64_t, Alloc>&ids) const
+		{
+			Visit(area, [&ids](const IDRect&item) {
+				ids.push_back(item.id);
+				return true;
+			});
+		}
+
+		size_t Count(const DRect&area) const;
+
+		static inline bool touches(const DRect&a, const DRect&b) {
+			return !(a.right < b.left || b.right < a.left || a.bottom < b.top || b.bottom < a.top);
+		}
+	};
+
+	/// <summary>
+	/// Static packed R-tree over IDRects, bulk loaded with sort-tile-recursive
+	/// ordering. Items are copied normalized and reordered into leaf order.</summary>
+	class DRectIndex
+	{
+	public:
+		static const uint32_t NodeSize = 16;
+
+		DRectIndex() {}
+		DRectIndex(const IDRArray&rects) { Build(rects); }
+
+		void Build(const IDRArray&rects);
+		// ids are the array positions
+		void Build(const DRectArray&rects);
+		void clear();
+
+		inline size_t size() const { return items.size(); }
+		inline bool isEmpty() const { return items.empty(); }
+		inline DRect bounds() const { return view().bounds(); }
+
+		inline const IDRArray& getItems() const { return items; }
+		inline const std::vector<DRectIndexNode>& getNodes() const { return nodes; }
+		inline size_t leafNodeCount() const { return leafCount; }
+
+		inline DRectIndexView view() const {
+			DRectIndexView result;
+			result.nodes = nodes.data();
+			result.nodeCount = nodes.size();
+			result.leafCount = leafCount;
+			result.items = items.data();
+			result.itemCount = items.size();
+			return result;
+		}
+
+		template <class Alloc>
+		inline void Search(const DRect&area, std::vector<IDRect, Alloc>&results) const { view().Search(area, results); }
+		template <class Alloc>
+		inline void Search(const DRect&area, std::vector<uint64_t, Alloc>&ids) const { view().Search(area, ids); }
+		inline size_t Count(const DRect&area) const { return view().Count(area); }
+
+	private:
+		void buildNodes();
+
+		IDRArray items;
+		std::vector<DRectIndexNode> nodes;
+		size_t leafCount = 0;
+	};
+
+}
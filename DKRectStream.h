@@ -0,0 +1,211 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKGeometry.h"
+
+namespace DKGeometry
+{
+	// key reported for overlapping stream elements: the id when there is one, else the stream position
+	inline uint64_t StreamKey(const DRect&, uint64_t position) { return position; }
+	inline uint64_t StreamKey(const IDRect&rect, uint64_t) { return rect.id; }
+
+	/// <summary>
+	/// Chunked pipeline over a rect stream of any length. The source fills a
+	/// fixed-size buffer that is reused for every chunk, each stage works on
+	/// the chunk in place, and only the overlap window is kept between
+	/// chunks, so memory stays at chunkSize + window rects.</summary>
+	template <class RectType>
+	class DRectPipeline
+	{
+	public:
+		// fills buffer with up to capacity rects, returns 0 at the end of the stream
+		typedef std::function<size_t(RectType*buffer, size_t capacity)> SourceFunc;
+		// receives each processed chunk, returns false to stop the stream
+		typedef std::function<bool(const RectType*rects, size_t count)> SinkFunc;
+		typedef std::function<void(uint64_t first, uint64_t second)> OverlapFunc;
+
+		explicit DRectPipeline(size_t chunkSize = 4096)
+			: buffer((std::max)(chunkSize, (size_t)1)) {}
+
+		// keeps rects for which predicate returns true
+		DRectPipeline& filter(std::function<bool(const RectType&)> predicate)
+		{
+			stages.push_back([predicate](RectType*rects, size_t count) {
+				size_t kept = 0;
+				for (size_t i = 0; i < count; i++)
+				{
+					if (predicate(rects[i])) rects[kept++] = rects[i];
+				}
+				return kept;
+			});
+			return *this;
+		}
+
+		// keeps rects that touch area, as DRect::Intersects
+		DRectPipeline& filterIntersects(const DRect&area)
+		{
+			DRect query(area);
+			query.Normalize();
+			stages.push_back([query](RectType*rects, size_t count) {
+				size_t kept = 0;
+				for (size_t i = 0; i < count; i++)
+				{
+					DRect rect(rects[i]);
+					rect.Normalize();
+					if (!(rect.right < query.left || query.right < rect.left ||
+						rect.bottom < query.top || query.bottom < rect.top))
+						rects[kept++] = rects[i];
+				}
+				return kept;
+			});
+			return *this;
+		}
+
+		DRectPipeline& transform(std::function<void(RectType&)> func)
+		{
+			stages.push_back([func](RectType*rects, size_t count) {
+				for (size_t i = 0; i < count; i++) func(rects[i]);
+				return count;
+			});
+			return *this;
+		}
+
+		/// <summary>
+		/// Accumulates the union of every rect reaching this stage into bounds,
+		/// which is reset to an empty (inverted) rect when the pipeline runs.</summary>
+		DRectPipeline& combineBounds(DRect&bounds)
+		{
+			DRect*target = &bounds;
+			resets.push_back([target]() { *target = DRect(DKInfinity, DKInfinity, DKNegInfinity, DKNegInfinity); });
+			stages.push_back([target](RectType*rects, size_t count) {
+				for (size_t i = 0; i < count; i++) target->CombineWith(rects[i]);
+				return count;
+			});
+			return *this;
+		}
+
+		/// <summary>
+		/// Reports every pair of rects reaching this stage that intersect and are
+		/// at most window positions apart, keyed by StreamKey.</summary>
+		DRectPipeline& detectOverlaps(size_t window, OverlapFunc onOverlap)
+		{
+			struct Entry { DRect rect; uint64_t key; };
+			struct WindowState {
+				std::vector<Entry> ring;
+				size_t next = 0;
+				uint64_t position = 0;
+			};
+			auto state = std::make_shared<WindowState>();
+			state->ring.reserve(window);
+
+			resets.push_back([state]() {
+				state->ring.clear();
+				state->next = 0;
+				state->position = 0;
+			});
+			stages.push_back([state, window, onOverlap](RectType*rects, size_t count) {
+				for (size_t i = 0; i < count; i++)
+				{
+					Entry entry = { rects[i], StreamKey(rects[i], state->position++) };
+					entry.rect.Normalize();
+					const DRect&a = entry.rect;
+					for (const auto&eachEntry : state->ring)
+					{
+						const DRect&b = eachEntry.rect;
+						if (!(a.right < b.left || b.right < a.left || a.bottom < b.top || b.bottom < a.top))
+							onOverlap(eachEntry.key, entry.key);
+					}
+					if (window == 0) continue;
+					if (state->ring.size() < window) {
+						state->ring.push_back(entry);
+					}
+					else {
+						state->ring[state->next] = entry;
+						state->next = (state->next + 1) % window;
+					}
+				}
+				return count;
+			});
+			return *this;
+		}
+
+		DRectPipeline& sink(SinkFunc func)
+		{
+			sinkFunc = func;
+			return *this;
+		}
+
+		/// <summary>
+		/// Pulls chunks from source until it runs dry or the sink stops it.</summary>
+		/// <returns>
+		/// number of rects read from source
+		/// </returns>
+		uint64_t run(SourceFunc source)
+		{
+			for (auto&eachReset : resets) eachReset();
+
+			uint64_t total = 0;
+			for (;;)
+			{
+				size_t count = source(buffer.data(), buffer.size());
+				if (count == 0) break;
+				total += count;
+
+				for (auto&eachStage : stages)
+				{
+					count = eachStage(buffer.data(), count);
+					if (count == 0) break;
+				}
+				if (count && sinkFunc && !sinkFunc(buffer.data(), count)) break;
+			}
+			return total;
+		}
+
+		// source over an in-memory array, mostly for replay and testing
+		static SourceFunc FromArray(const RectType*rects, size_t count)
+		{
+			auto position = std::make_shared<size_t>(0);
+			return [rects, count, position](RectType*out, size_t capacity) {
+				size_t taken = (std::min)(capacity, count - *position);
+				std::copy(rects + *position, rects + *position + taken, out);
+				*position += taken;
+				return taken;
+			};
+		}
+
+		inline size_t chunkSize() const { return buffer.size(); }
+
+	private:
+		std::vector<RectType> buffer;
+		std::vector<std::function<size_t(RectType*, size_t)>> stages;
+		std::vector<std::function<void()>> resets;
+		SinkFunc sinkFunc;
+	};
+
+	typedef DRectPipeline<DRect> DRectStream;
+	typedef DRectPipeline<IDRect> IDRectStream;
+
+}
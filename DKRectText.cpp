@@ -0,0 +1,262 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKRectText.h"
+
+#include <charconv>
+#include <string.h>
+
+using namespace DKGeometry;
+
+
+// shortest round-trip floats need at most 15 characters, integers at most 20
+static const size_t maxFieldSize = 24;
+
+static inline char* writeField(char*p, char*end, float value)
+{
+	return std::to_chars(p, end, value).ptr;
+}
+
+static inline char* writeField(char*p, char*end, uint64_t value)
+{
+	return std::to_chars(p, end, value).ptr;
+}
+
+static inline char* writeField(char*p, char*end, uint32_t value)
+{
+	return std::to_chars(p, end, value).ptr;
+}
+
+template <class T, class WriteFields>
+static DTextResult formatArray(const T*items, size_t count, char*buffer, size_t capacity,
+	DTextFormat format, size_t fieldCount, WriteFields writeFields)
+{
+	DTextResult result = { 0, 0 };
+	bool json = (format == DTextJSON);
+	char separator = (format == DTextPlain) ? ' ' : ',';
+	size_t maxElement = fieldCount * maxFieldSize + 4;
+
+	char*p = buffer;
+	char*end = buffer + capacity;
+	if (json)
+	{
+		if (capacity < 2) return result;
+		*p++ = '[';
+		end--; // room for the closing bracket
+	}
+
+	char temp[8 * maxFieldSize];
+	for (size_t i = 0; i < count; i++)
+	{
+		// format straight into the buffer unless the element might not fit
+		bool direct = (size_t)(end - p) >= maxElement;
+		char*q = direct ? p : temp;
+		char*qEnd = direct ? end : temp + sizeof(temp);
+
+		if (json)
+		{
+			if (i) *q++ = ',';
+			*q++ = '[';
+		}
+		q = writeFields(q, qEnd, items[i], separator);
+		*q++ = json ? ']' : '\n';
+
+		if (direct) {
+			p = q;
+		}
+		else {
+			size_t length = q - temp;
+			if (length > (size_t)(end - p)) break;
+			memcpy(p, temp, length);
+			p += length;
+		}
+		result.count++;
+	}
+
+	if (json) *p++ = ']';
+	result.bytes = p - buffer;
+	return result;
+}
+
+DTextResult DKGeometry::FormatRects(const DRect * rects, size_t count, char * buffer, size_t capacity, DTextFormat format)
+{
+	return formatArray(rects, count, buffer, capacity, format, 4, [](char*p, char*end, const DRect&rect, char separator) {
+		p = writeField(p, end, rect.left);
+		*p++ = separator;
+		p = writeField(p, end, rect.top);
+		*p++ = separator;
+		p = writeField(p, end, rect.right);
+		*p++ = separator;
+		return writeField(p, end, rect.bottom);
+	});
+}
+
+DTextResult DKGeometry::FormatRects(const IDRect * rects, size_t count, char * buffer, size_t capacity, DTextFormat format)
+{
+	return formatArray(rects, count, buffer, capacity, format, 5, [](char*p, char*end, const IDRect&rect, char separator) {
+		p = writeField(p, end, rect.id);
+		*p++ = separator;
+		p = writeField(p, end, rect.left);
+		*p++ = separator;
+		p = writeField(p, end, rect.top);
+		*p++ = separator;
+		p = writeField(p, end, rect.right);
+		*p++ = separator;
+		return writeField(p, end, rect.bottom);
+	});
+}
+
+DTextResult DKGeometry::FormatPoints(const DPoint * points, size_t count, char * buffer, size_t capacity, DTextFormat format)
+{
+	return formatArray(points, count, buffer, capacity, format, 2, [](char*p, char*end, const DPoint&point, char separator) {
+		p = writeField(p, end, point.x);
+		*p++ = separator;
+		return writeField(p, end, point.y);
+	});
+}
+
+DTextResult DKGeometry::FormatRanges(const DRange * ranges, size_t count, char * buffer, size_t capacity, DTextFormat format)
+{
+	return formatArray(ranges, count, buffer, capacity, format, 2, [](char*p, char*end, const DRange&range, char separator) {
+		p = writeField(p, end, range.start);
+		*p++ = separator;
+		return writeField(p, end, range.length);
+	});
+}
+
+size_t DKGeometry::MaxFormattedSize(size_t count, size_t floatFields, bool hasId)
+{
+	return count * ((floatFields + (hasId ? 1 : 0)) * maxFieldSize + 4) + 2;
+}
+
+
+static inline bool isSeparator(char c)
+{
+	return c == ' ' || c == ',' || c == '\n' || c == '\r' || c == '\t' || c == '[' || c == ']';
+}
+
+static inline const char* skipSeparators(const char*p, const char*end)
+{
+	while (p < end && isSeparator(*p)) p++;
+	return p;
+}
+
+template <class T>
+static inline bool readField(const char*&p, const char*end, T&value, bool final)
+{
+	const char*start = skipSeparators(p, end);
+	const char*tokenEnd = start;
+	while (tokenEnd < end && !isSeparator(*tokenEnd)) tokenEnd++;
+
+	// a token running into the end of a chunk may continue in the next one
+	if (start == tokenEnd || (tokenEnd == end && !final)) return false;
+
+	auto result = std::from_chars(start, tokenEnd, value);
+	if (result.ec != std::errc() || result.ptr != tokenEnd) return false;
+
+	p = tokenEnd;
+	return true;
+}
+
+static inline bool readElement(const char*&p, const char*end, DRect&rect, bool final)
+{
+	return readField(p, end, rect.left, final) && readField(p, end, rect.top, final) &&
+		readField(p, end, rect.right, final) && readField(p, end, rect.bottom, final);
+}
+
+static inline bool readElement(const char*&p, const char*end, IDRect&rect, bool final)
+{
+	return readField(p, end, rect.id, final) && readElement(p, end, (DRect&)rect, final);
+}
+
+static inline bool readElement(const char*&p, const char*end, DPoint&point, bool final)
+{
+	return readField(p, end, point.x, final) && readField(p, end, point.y, final);
+}
+
+static inline bool readElement(const char*&p, const char*end, DRange&range, bool final)
+{
+	return readField(p, end, range.start, final) && readField(p, end, range.length, final);
+}
+
+template <class T, class Alloc>
+static DTextResult parseArray(const char*text, size_t length, std::vector<T, Alloc>&out, bool final)
+{
+	DTextResult result = { 0, 0 };
+	const char*p = text;
+	const char*end = text + length;
+
+	for (;;)
+	{
+		const char*q = p;
+		T value;
+		if (!readElement(q, end, value, final)) break;
+		out.push_back(value);
+		p = q;
+		result.count++;
+	}
+
+	if (final) p = skipSeparators(p, end);
+	result.bytes = p - text;
+	return result;
+}
+
+DTextResult DKGeometry::ParseRects(const char * text, size_t length, DRectArray & out, bool final)
+{
+	return parseArray(text, length, out, final);
+}
+
+DTextResult DKGeometry::ParseRects(const char * text, size_t length, IDRArray & out, bool final)
+{
+	return parseArray(text, length, out, final);
+}
+
+DTextResult DKGeometry::ParsePoints(const char * text, size_t length, DPointArray & out, bool final)
+{
+	return parseArray(text, length, out, final);
+}
+
+DTextResult DKGeometry::ParseRanges(const char * text, size_t length, std::vector<DRange>&out, bool final)
+{
+	return parseArray(text, length, out, final);
+}
+
+DTextResult DKGeometry::ParseRects(const char * text, size_t length, pmr::DRectArray & out, bool final)
+{
+	return parseArray(text, length, out, final);
+}
+
+DTextResult DKGeometry::ParseRects(const char * text, size_t length, pmr::IDRArray & out, bool final)
+{
+	return parseArray(text, length, out, final);
+}
+
+DTextResult DKGeometry::ParsePoints(const char * text, size_t length, pmr::DPointArray & out, bool final)
+{
+	return parseArray(text, length, out, final);
+}
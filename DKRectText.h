@@ -0,0 +1,81 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKGeometry.h"
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Text layouts for batch formatting:
+	///   DTextPlain  one element per line, space separated, e.g. "10 20 110 220"
+	///   DTextCSV    one element per line, comma separated, e.g. "10,20,110,220"
+	///   DTextJSON   one compact array of arrays, e.g. "[[10,20,110,220],[...]]"
+	/// Rects are written as left, top, right, bottom; IDRects lead with the id;
+	/// DRanges are start, length. Floats use the shortest form that reads back
+	/// to the identical value.</summary>
+	enum DTextFormat
+	{
+		DTextPlain = 0,
+		DTextCSV = 1,
+		DTextJSON = 2
+	};
+
+	struct DTextResult
+	{
+		size_t bytes;	// characters written or consumed
+		size_t count;	// elements formatted or parsed
+	};
+
+	/// <summary>
+	/// Formats as many whole elements as fit in buffer. Plain and CSV output
+	/// can be produced in pieces by calling again from rects + result.count;
+	/// JSON is only a complete document when every element fits, see
+	/// MaxFormattedSize.</summary>
+	DTextResult FormatRects(const DRect*rects, size_t count, char*buffer, size_t capacity, DTextFormat format = DTextCSV);
+	DTextResult FormatRects(const IDRect*rects, size_t count, char*buffer, size_t capacity, DTextFormat format = DTextCSV);
+	DTextResult FormatPoints(const DPoint*points, size_t count, char*buffer, size_t capacity, DTextFormat format = DTextCSV);
+	DTextResult FormatRanges(const DRange*ranges, size_t count, char*buffer, size_t capacity, DTextFormat format = DTextCSV);
+
+	// upper bound on the output size of count elements of the given type
+	size_t MaxFormattedSize(size_t count, size_t floatFields, bool hasId);
+
+	/// <summary>
+	/// Parses numbers from any of the DTextFormat layouts, appending to out.
+	/// Whitespace, commas and brackets all act as separators. Parsing stops
+	/// at the first token that is not a number or at the end of text, and a
+	/// trailing partial element is left unconsumed. Pass final = false for
+	/// all but the last piece of chunked input, so a number cut off by the
+	/// chunk boundary is also held back; resume from text + result.bytes.</summary>
+	DTextResult ParseRects(const char*text, size_t length, DRectArray&out, bool final = true);
+	DTextResult ParseRects(const char*text, size_t length, IDRArray&out, bool final = true);
+	DTextResult ParsePoints(const char*text, size_t length, DPointArray&out, bool final = true);
+	DTextResult ParseRanges(const char*text, size_t length, std::vector<DRange>&out, bool final = true);
+
+	DTextResult ParseRects(const char*text, size_t length, pmr::DRectArray&out, bool final = true);
+	DTextResult ParseRects(const char*text, size_t length, pmr::IDRArray&out, bool final = true);
+	DTextResult ParsePoints(const char*text, size_t length, pmr::DPointArray&out, bool final = true);
+
+}
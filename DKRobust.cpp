@@ -0,0 +1,144 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+
+#include "DKRobust.h"
+
+#include <math.h>
+
+using namespace DKGeometry;
+
+
+namespace
+{
+	// relative error bound of the double filter, (3 + 16 eps) * eps with eps = 2^-53
+	const double OrientErrorBound = (3.0 + 16.0 * DBL_EPSILON / 2) * (DBL_EPSILON / 2);
+
+	inline int sign(double value)
+	{
+		return (value > 0) - (value < 0);
+	}
+
+	// The product of two floats is exact in a double, so the determinant
+	// expanded into six products is an exact sum of six doubles. Accumulate it
+	// as a nonoverlapping expansion (two-sum with zero elimination); the sign
+	// of the largest component is the sign of the whole.
+	int exactOrient(const DPoint&a, const DPoint&b, const DPoint&c)
+	{
+		const double terms[6] = {
+			(double)a.x * b.y, -(double)a.x * c.y,
+			(double)b.x * c.y, -(double)b.x * a.y,
+			(double)c.x * a.y, -(double)c.x * b.y
+		};
+
+		double expansion[6];
+		int length = 0;
+		for (double term : terms)
+		{
+			double q = term;
+			int out = 0;
+			for (int i = 0; i < length; i++)
+			{
+				double sum = q + expansion[i];
+				double bVirtual = sum - q;
+				double aVirtual = sum - bVirtual;
+				double error = (q - aVirtual) + (expansion[i] - bVirtual);
+				q = sum;
+				if (error != 0) expansion[out++] = error;
+			}
+			if (q != 0) expansion[out++] = q;
+			length = out;
+		}
+		return length ? sign(expansion[length - 1]) : 0;
+	}
+
+	inline bool inBox(const DPoint&a, const DPoint&b, const DPoint&p)
+	{
+		return (std::min)(a.x, b.x) <= p.x && p.x <= (std::max)(a.x, b.x) &&
+			(std::min)(a.y, b.y) <= p.y && p.y <= (std::max)(a.y, b.y);
+	}
+
+	// NaN slips through the box compares and orients as collinear, and
+	// infinities overflow the exact sums; neither touches anything
+	inline bool isFinite(const DPoint&p)
+	{
+		return std::isfinite(p.x) && std::isfinite(p.y);
+	}
+}
+
+
+int DKGeometry::Orient2D(const DPoint & a, const DPoint & b, const DPoint & c)
+{
+	double left = ((double)b.x - a.x) * ((double)c.y - a.y);
+	double right = ((double)b.y - a.y) * ((double)c.x - a.x);
+	double det = left - right;
+
+	// opposite signs or a zero side can't cancel, the sign is already exact
+	if (left > 0) {
+		if (right <= 0) return sign(det);
+	}
+	else if (left < 0) {
+		if (right >= 0) return sign(det);
+	}
+	else {
+		return sign(det);
+	}
+
+	double bound = OrientErrorBound * fabs(left + right);
+	if (det > bound || -det > bound) return sign(det);
+
+	return exactOrient(a, b, c);
+}
+
+bool DKGeometry::PointOnSegment(const DPoint & a, const DPoint & b, const DPoint & p)
+{
+	if (!isFinite(a) || !isFinite(b) || !isFinite(p)) return false;
+	return inBox(a, b, p) && Orient2D(a, b, p) == 0;
+}
+
+bool DKGeometry::SegmentsTouch(const DPoint & a1, const DPoint & a2, const DPoint & b1, const DPoint & b2)
+{
+	if (!isFinite(a1) || !isFinite(a2) || !isFinite(b1) || !isFinite(b2)) return false;
+
+	// cheap reject on the bounding boxes before any orientation
+	if ((std::max)(a1.x, a2.x) < (std::min)(b1.x, b2.x) || (std::max)(b1.x, b2.x) < (std::min)(a1.x, a2.x) ||
+		(std::max)(a1.y, a2.y) < (std::min)(b1.y, b2.y) || (std::max)(b1.y, b2.y) < (std::min)(a1.y, a2.y))
+		return false;
+
+	int d1 = Orient2D(b1, b2, a1);
+	int d2 = Orient2D(b1, b2, a2);
+	if (d1 && d1 == d2) return false;
+
+	int d3 = Orient2D(a1, a2, b1);
+	int d4 = Orient2D(a1, a2, b2);
+	if (d3 && d3 == d4) return false;
+
+	// each straddles the other's line; when all four are collinear the
+	// overlapping boxes already mean the segments overlap
+	return true;
+}
@@ -0,0 +1,52 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKGeometry.h"
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Exact orientation of c relative to the directed line a-b.
+	/// A double precision filter settles almost every call; only nearly
+	/// collinear inputs fall through to an exact expansion sum.</summary>
+	/// <returns>
+	/// 1 if c is left of a-b in y-up terms (clockwise on screen, y down),
+	/// -1 if it is right of it, 0 if the three points are collinear
+	/// </returns>
+	int Orient2D(const DPoint&a, const DPoint&b, const DPoint&c);
+
+	/// <summary>
+	/// Exact test for p lying on the closed segment a-b; false for NaN or
+	/// infinite coordinates.</summary>
+	bool PointOnSegment(const DPoint&a, const DPoint&b, const DPoint&p);
+
+	/// <summary>
+	/// Exact test for the closed segments a1-a2 and b1-b2 sharing at least
+	/// one point, collinear overlaps and touching endpoints included; false
+	/// for NaN or infinite coordinates.</summary>
+	bool SegmentsTouch(const DPoint&a1, const DPoint&a2, const DPoint&b1, const DPoint&b2);
+
+}
@@ -0,0 +1,459 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+
+#include "DKSceneGraph.h"
+
+using namespace DKGeometry;
+
+
+void DKGeometry::DSceneGraph::clear()
+{
+	ids.clear();
+	parents.clear();
+	firstChildren.clear();
+	lastChildren.clear();
+	nextSiblings.clear();
+	prevSiblings.clear();
+	firstTop = lastTop = NoNode;
+	offsets.clear();
+	rects.clear();
+	subtreeBounds.clear();
+	dirty.clear();
+	worldOrigins.clear();
+	originEpochs.clear();
+	topDirty = false;
+	epoch = 1;
+	freeSlots.clear();
+	slots.clear();
+}
+
+void DKGeometry::DSceneGraph::reserve(size_t count)
+{
+	ids.reserve(count);
+	parents.reserve(count);
+	firstChildren.reserve(count);
+	lastChildren.reserve(count);
+	nextSiblings.reserve(count);
+	prevSiblings.reserve(count);
+	offsets.reserve(count);
+	rects.reserve(count);
+	subtreeBounds.reserve(count);
+	dirty.reserve(count);
+	worldOrigins.reserve(count);
+	originEpochs.reserve(count);
+	slots.reserve(count);
+}
+
+uint32_t DKGeometry::DSceneGraph::find(uint64_t id) const
+{
+	auto found = slots.find(id);
+	return found == slots.end() ? NoNode : found->second;
+}
+
+uint32_t DKGeometry::DSceneGraph::allocate(const IDRect & localRect, const DPoint & offset)
+{
+	uint32_t node;
+	if (!freeSlots.empty())
+	{
+		node = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else
+	{
+		node = (uint32_t)ids.size();
+		ids.push_back(0);
+		parents.push_back(NoNode);
+		firstChildren.push_back(NoNode);
+		lastChildren.push_back(NoNode);
+		nextSiblings.push_back(NoNode);
+		prevSiblings.push_back(NoNode);
+		offsets.push_back(DPoint(0, 0));
+		rects.push_back(DRect());
+		subtreeBounds.push_back(DRect());
+		dirty.push_back(0);
+		worldOrigins.push_back(DPoint(0, 0));
+		originEpochs.push_back(0);
+	}
+
+	ids[node] = localRect.id;
+	parents[node] = NoNode;
+	firstChildren[node] = lastChildren[node] = NoNode;
+	nextSiblings[node] = prevSiblings[node] = NoNode;
+	offsets[node] = offset;
+	rects[node] = localRect;
+	subtreeBounds[node] = localRect;
+	dirty[node] = 0;
+	originEpochs[node] = 0;
+	slots.emplace(localRect.id, node);
+	return node;
+}
+
+void DKGeometry::DSceneGraph::link(uint32_t node, uint32_t parent)
+{
+	uint32_t&first = (parent == NoNode) ? firstTop : firstChildren[parent];
+	uint32_t&last = (parent == NoNode) ? lastTop : lastChildren[parent];
+
+	parents[node] = parent;
+	prevSiblings[node] = last;
+	nextSiblings[node] = NoNode;
+	if (last != NoNode) nextSiblings[last] = node;
+	else first = node;
+	last = node;
+}
+
+void DKGeometry::DSceneGraph::unlink(uint32_t node)
+{
+	uint32_t parent = parents[node];
+	uint32_t&first = (parent == NoNode) ? firstTop : firstChildren[parent];
+	uint32_t&last = (parent == NoNode) ? lastTop : lastChildren[parent];
+
+	uint32_t prev = prevSiblings[node];
+	uint32_t next = nextSiblings[node];
+	if (prev != NoNode) nextSiblings[prev] = next;
+	else first = next;
+	if (next != NoNode) prevSiblings[next] = prev;
+	else last = prev;
+
+	parents[node] = NoNode;
+	prevSiblings[node] = nextSiblings[node] = NoNode;
+}
+
+void DKGeometry::DSceneGraph::markDirty(uint32_t node)
+{
+	// an already dirty node has dirty ancestors, so the walk can stop there
+	for (uint32_t i = node; i != NoNode && !dirty[i]; i = parents[i])
+	{
+		dirty[i] = 1;
+	}
+	topDirty = true;
+}
+
+void DKGeometry::DSceneGraph::markParentDirty(uint32_t node)
+{
+	if (parents[node] != NoNode) markDirty(parents[node]);
+	else topDirty = true;
+}
+
+void DKGeometry::DSceneGraph::advanceEpoch()
+{
+	if (++epoch == 0)
+	{
+		// wrapped, forget every cached origin rather than trust a stale stamp
+		std::fill(originEpochs.begin(), originEpochs.end(), 0);
+		epoch = 1;
+	}
+}
+
+bool DKGeometry::DSceneGraph::insert(const IDRect & localRect, const DPoint & offset)
+{
+	if (slots.count(localRect.id)) return false;
+
+	uint32_t node = allocate(localRect, offset);
+	link(node, NoNode);
+	topDirty = true;
+	return true;
+}
+
+bool DKGeometry::DSceneGraph::insertChild(uint64_t parentId, const IDRect & localRect, const DPoint & offset)
+{
+	uint32_t parent = find(parentId);
+	if (parent == NoNode || slots.count(localRect.id)) return false;
+
+	uint32_t node = allocate(localRect, offset);
+	link(node, parent);
+	markDirty(parent);
+	return true;
+}
+
+bool DKGeometry::DSceneGraph::remove(uint64_t id)
+{
+	uint32_t node = find(id);
+	if (node == NoNode) return false;
+
+	markParentDirty(node);
+	unlink(node);
+
+	std::vector<uint32_t> pending(1, node);
+	while (!pending.empty())
+	{
+		uint32_t i = pending.back();
+		pending.pop_back();
+		for (uint32_t child = firstChildren[i]; child != NoNode; child = nextSiblings[child])
+		{
+			pending.push_back(child);
+		}
+		slots.erase(ids[i]);
+		freeSlots.push_back(i);
+	}
+	return true;
+}
+
+bool DKGeometry::DSceneGraph::setParent(uint64_t id, uint64_t parentId)
+{
+	uint32_t node = find(id);
+	uint32_t parent = find(parentId);
+	if (node == NoNode || parent == NoNode) return false;
+
+	for (uint32_t i = parent; i != NoNode; i = parents[i])
+	{
+		if (i == node) return false;
+	}
+	if (parents[node] == parent) return true;
+
+	markParentDirty(node);
+	unlink(node);
+	link(node, parent);
+	markDirty(parent);
+	advanceEpoch();
+	return true;
+}
+
+bool DKGeometry::DSceneGraph::makeTopLevel(uint64_t id)
+{
+	uint32_t node = find(id);
+	if (node == NoNode) return false;
+	if (parents[node] == NoNode) return true;
+
+	markParentDirty(node);
+	unlink(node);
+	link(node, NoNode);
+	topDirty = true;
+	advanceEpoch();
+	return true;
+}
+
+bool DKGeometry::DSceneGraph::setOffset(uint64_t id, const DPoint & offset)
+{
+	uint32_t node = find(id);
+	if (node == NoNode) return false;
+	if (offsets[node].x == offset.x && offsets[node].y == offset.y) return true;
+
+	// the node's own bounds live in its frame and do not change
+	offsets[node] = offset;
+	markParentDirty(node);
+	advanceEpoch();
+	return true;
+}
+
+bool DKGeometry::DSceneGraph::offsetBy(uint64_t id, float xAmount, float yAmount)
+{
+	uint32_t node = find(id);
+	if (node == NoNode) return false;
+
+	return setOffset(id, DPoint(offsets[node].x + xAmount, offsets[node].y + yAmount));
+}
+
+bool DKGeometry::DSceneGraph::setRect(uint64_t id, const DRect & localRect)
+{
+	uint32_t node = find(id);
+	if (node == NoNode) return false;
+
+	rects[node] = localRect;
+	markDirty(node);
+	return true;
+}
+
+bool DKGeometry::DSceneGraph::getLocalRect(uint64_t id, DRect & rect) const
+{
+	uint32_t node = find(id);
+	if (node == NoNode) return false;
+
+	rect = rects[node];
+	return true;
+}
+
+bool DKGeometry::DSceneGraph::getOffset(uint64_t id, DPoint & offset) const
+{
+	uint32_t node = find(id);
+	if (node == NoNode) return false;
+
+	offset = offsets[node];
+	return true;
+}
+
+bool DKGeometry::DSceneGraph::getParent(uint64_t id, uint64_t & parentId, bool & isTopLevel) const
+{
+	uint32_t node = find(id);
+	if (node == NoNode) return false;
+
+	isTopLevel = parents[node] == NoNode;
+	parentId = isTopLevel ? 0 : ids[parents[node]];
+	return true;
+}
+
+bool DKGeometry::DSceneGraph::getWorldRect(uint64_t id, DRect & rect) const
+{
+	uint32_t node = find(id);
+	if (node == NoNode) return false;
+
+	rect = rects[node] + worldOrigin(node);
+	return true;
+}
+
+bool DKGeometry::DSceneGraph::getSubtreeBounds(uint64_t id, DRect & rect) const
+{
+	uint32_t node = find(id);
+	if (node == NoNode) return false;
+
+	ensureBounds(node);
+	rect = subtreeBounds[node] + worldOrigin(node);
+	return true;
+}
+
+DRect DKGeometry::DSceneGraph::bounds() const
+{
+	if (firstTop == NoNode) return DRect();
+
+	if (topDirty)
+	{
+		ensureBounds(firstTop);
+		topBounds = subtreeBounds[firstTop] + offsets[firstTop];
+		for (uint32_t i = nextSiblings[firstTop]; i != NoNode; i = nextSiblings[i])
+		{
+			ensureBounds(i);
+			topBounds = combined(topBounds, subtreeBounds[i] + offsets[i]);
+		}
+		topDirty = false;
+	}
+	return topBounds;
+}
+
+void DKGeometry::DSceneGraph::ensureBounds(uint32_t node) const
+{
+	if (!dirty[node]) return;
+
+	// post-order over the dirty part of the subtree only
+	struct Frame { uint32_t node; bool expanded; };
+	std::vector<Frame> stack(1, { node, false });
+	while (!stack.empty())
+	{
+		Frame&top = stack.back();
+		uint32_t i = top.node;
+		if (!top.expanded)
+		{
+			top.expanded = true;
+			for (uint32_t child = firstChildren[i]; child != NoNode; child = nextSiblings[child])
+			{
+				if (dirty[child]) stack.push_back({ child, false });
+			}
+			continue;
+		}
+		stack.pop_back();
+
+		DRect box = rects[i];
+		for (uint32_t child = firstChildren[i]; child != NoNode; child = nextSiblings[child])
+		{
+			box = combined(box, subtreeBounds[child] + offsets[child]);
+		}
+		subtreeBounds[i] = box;
+		dirty[i] = 0;
+	}
+}
+
+DPoint DKGeometry::DSceneGraph::worldOrigin(uint32_t node) const
+{
+	// climb to the nearest ancestor with a current origin, then fill downwards
+	uint32_t path[64];
+	std::vector<uint32_t> longPath;
+	size_t depth = 0;
+
+	uint32_t i = node;
+	while (i != NoNode && originEpochs[i] != epoch)
+	{
+		if (depth < 64) path[depth] = i;
+		else longPath.push_back(i);
+		depth++;
+		i = parents[i];
+	}
+
+	DPoint origin = (i == NoNode) ? DPoint(0, 0) : worldOrigins[i];
+	while (depth)
+	{
+		depth--;
+		uint32_t j = (depth < 64) ? path[depth] : longPath[depth - 64];
+		origin = origin + offsets[j];
+		worldOrigins[j] = origin;
+		originEpochs[j] = epoch;
+	}
+	return origin;
+}
+
+template <class Visit>
+void DKGeometry::DSceneGraph::visit(const DRect * area, Visit visitor) const
+{
+	if (area) bounds();
+
+	struct Item { uint32_t node; DPoint parentOrigin; };
+	std::vector<Item> stack;
+	for (uint32_t i = lastTop; i != NoNode; i = prevSiblings[i])
+	{
+		stack.push_back({ i, DPoint(0, 0) });
+	}
+
+	while (!stack.empty())
+	{
+		Item item = stack.back();
+		stack.pop_back();
+
+		uint32_t i = item.node;
+		DPoint origin = item.parentOrigin + offsets[i];
+		if (area && !(subtreeBounds[i] + origin).Intersects(*area)) continue;
+
+		DRect world = rects[i] + origin;
+		if (!area || world.Intersects(*area)) visitor(i, world);
+
+		// pushed in reverse so siblings come out in insertion order
+		for (uint32_t child = lastChildren[i]; child != NoNode; child = prevSiblings[child])
+		{
+			stack.push_back({ child, origin });
+		}
+	}
+}
+
+void DKGeometry::DSceneGraph::Search(const DRect & area, IDRArray & results) const
+{
+	visit(&area, [this, &results](uint32_t node, const DRect&world) {
+		results.push_back(IDRect(world, ids[node]));
+	});
+}
+
+void DKGeometry::DSceneGraph::Search(const DRect & area, std::vector<uint64_t>& results) const
+{
+	visit(&area, [this, &results](uint32_t node, const DRect&) {
+		results.push_back(ids[node]);
+	});
+}
+
+void DKGeometry::DSceneGraph::getWorldRects(IDRArray & results) const
+{
+	results.reserve(results.size() + slots.size());
+	visit(nullptr, [this, &results](uint32_t node, const DRect&world) {
+		results.push_back(IDRect(world, ids[node]));
+	});
+}
@@ -0,0 +1,146 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKGeometry.h"
+
+#include <unordered_map>
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Hierarchy of IDRects placed by translation. Each node has a rect in its
+	/// own frame and an offset from its parent's frame; a top-level node's
+	/// parent frame is world space. World rect = local rect + sum of the
+	/// offsets from the node up to the top.
+	///
+	/// Nodes live in flat parallel arrays indexed by slot. Subtree bounds are
+	/// cached in each node's own frame, so moving a node leaves its whole
+	/// subtree untouched: only the bounds of its ancestors are flagged dirty,
+	/// and those are recomputed lazily from their direct children on the next
+	/// query. Cached world origins are stamped with an epoch that every move
+	/// advances, and are rebuilt on demand from the nearest valid ancestor.
+	///
+	/// Bounds combine like GetCombinedRect; with non-integral offsets they can
+	/// differ from it by float rounding of the accumulated offsets.
+	/// Const queries fill the caches, so they need external locking if shared
+	/// between threads.</summary>
+	class DSceneGraph
+	{
+	public:
+		DSceneGraph() {}
+
+		void clear();
+		void reserve(size_t count);
+
+		// false if the id is already present, or the parent is not
+		bool insert(const IDRect&localRect, const DPoint&offset = DPoint(0, 0));
+		bool insertChild(uint64_t parentId, const IDRect&localRect, const DPoint&offset = DPoint(0, 0));
+
+		// removes the node and all of its descendants; false if not present
+		bool remove(uint64_t id);
+
+		// moves the node, keeping its offset, under parentId or to the top level;
+		// false if either is missing or parentId is inside the node's subtree
+		bool setParent(uint64_t id, uint64_t parentId);
+		bool makeTopLevel(uint64_t id);
+
+		// O(depth): the subtree moves with the node without being visited
+		bool setOffset(uint64_t id, const DPoint&offset);
+		bool offsetBy(uint64_t id, float xAmount, float yAmount);
+		bool setRect(uint64_t id, const DRect&localRect);
+
+		bool getLocalRect(uint64_t id, DRect&rect) const;
+		bool getOffset(uint64_t id, DPoint&offset) const;
+		bool getParent(uint64_t id, uint64_t&parentId, bool&isTopLevel) const;
+		bool getWorldRect(uint64_t id, DRect&rect) const;
+		// world bounds of the node and its descendants
+		bool getSubtreeBounds(uint64_t id, DRect&rect) const;
+
+		// world bounds of every node, DRect() when empty
+		DRect bounds() const;
+
+		// nodes whose world rect intersects area, parents before children,
+		// pruned by subtree bounds
+		void Search(const DRect&area, IDRArray&results) const;
+		void Search(const DRect&area, std::vector<uint64_t>&ids) const;
+
+		// every world rect, parents before children, siblings in insertion order
+		void getWorldRects(IDRArray&results) const;
+
+		inline bool contains(uint64_t id) const { return slots.count(id) != 0; }
+		inline size_t size() const { return slots.size(); }
+		inline bool isEmpty() const { return slots.empty(); }
+
+	private:
+		static constexpr uint32_t NoNode = UINT32_MAX;
+
+		static inline DRect combined(const DRect&a, const DRect&b) {
+			return DRect((std::min)(a.left, b.left), (std::min)(a.top, b.top),
+				(std::max)(a.right, b.right), (std::max)(a.bottom, b.bottom));
+		}
+
+		uint32_t find(uint64_t id) const;
+		uint32_t allocate(const IDRect&localRect, const DPoint&offset);
+		void link(uint32_t node, uint32_t parent);
+		void unlink(uint32_t node);
+		void markDirty(uint32_t node);
+		void markParentDirty(uint32_t node);
+		void advanceEpoch();
+
+		void ensureBounds(uint32_t node) const;
+		DPoint worldOrigin(uint32_t node) const;
+
+		template <class Visit>
+		void visit(const DRect*area, Visit visitor) const;
+
+		// topology; parents[i] is NoNode for top-level nodes
+		std::vector<uint64_t> ids;
+		std::vector<uint32_t> parents;
+		std::vector<uint32_t> firstChildren;
+		std::vector<uint32_t> lastChildren;
+		std::vector<uint32_t> nextSiblings;
+		std::vector<uint32_t> prevSiblings;
+		uint32_t firstTop = NoNode;
+		uint32_t lastTop = NoNode;
+
+		// local placement
+		std::vector<DPoint> offsets;
+		std::vector<DRect> rects;
+
+		// lazily rebuilt caches; a dirty node's ancestors are always dirty
+		mutable std::vector<DRect> subtreeBounds;
+		mutable std::vector<uint8_t> dirty;
+		mutable std::vector<DPoint> worldOrigins;
+		mutable std::vector<uint32_t> originEpochs;
+		mutable DRect topBounds;
+		mutable bool topDirty = false;
+		uint32_t epoch = 1;
+
+		std::vector<uint32_t> freeSlots;
+		std::unordered_map<uint64_t, uint32_t> slots;
+	};
+
+}
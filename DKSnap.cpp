@@ -0,0 +1,171 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKSnap.h"
+
+#include <math.h>
+
+#ifdef DKGEOMETRY_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace DKGeometry;
+
+static_assert(sizeof(DRect) == 4 * sizeof(float), "SnapRects treats DRect arrays as floats");
+static_assert(sizeof(DPoint) == 2 * sizeof(float), "SnapPoints treats DPoint arrays as floats");
+
+
+namespace
+{
+	enum Rounding { RoundHalfPixel, RoundNearest, RoundFloor, RoundCeil };
+
+	inline float roundScalar(float f, Rounding rounding)
+	{
+		switch (rounding)
+		{
+		case RoundHalfPixel: return fixDim(f);
+		case RoundNearest: return nearbyintf(f);
+		case RoundFloor: return floorf(f);
+		default: return ceilf(f);
+		}
+	}
+
+	inline float snapScalar(float f, Rounding rounding, float scale)
+	{
+		if (scale == 1.f) return roundScalar(f, rounding);
+		return roundScalar(f * scale, rounding) / scale;
+	}
+
+#ifdef DKGEOMETRY_SSE2
+	// every float with magnitude 2^23 or more is already integral; NaN and
+	// infinity fall into that case too and pass through unchanged
+	inline __m128 alreadyIntegral(__m128 x)
+	{
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+		return _mm_cmpnlt_ps(_mm_and_ps(x, absMask), _mm_set1_ps(8388608.f));
+	}
+
+	inline __m128 select(__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	// keeps -0 where the scalar functions return it
+	inline __m128 withSign(__m128 r, __m128 x)
+	{
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+		return _mm_or_ps(r, _mm_and_ps(x, signMask));
+	}
+
+	inline __m128 truncate(__m128 x)
+	{
+		return select(alreadyIntegral(x), x, _mm_cvtepi32_ps(_mm_cvttps_epi32(x)));
+	}
+
+	inline __m128 halfPixel(__m128 x)
+	{
+		// same steps as fixDim: integer part, then +0.5 if the fraction is over 0.15
+		__m128 t = truncate(x);
+		__m128 fraction = _mm_sub_ps(x, t);
+		__m128 up = _mm_cmpgt_ps(fraction, _mm_set1_ps(0.15f));
+		return _mm_add_ps(t, select(up, _mm_set1_ps(0.5f), _mm_set1_ps(-0.5f)));
+	}
+
+	inline __m128 nearest(__m128 x)
+	{
+		__m128 r = _mm_cvtepi32_ps(_mm_cvtps_epi32(x));
+		return select(alreadyIntegral(x), x, withSign(r, x));
+	}
+
+	inline __m128 floorCeil(__m128 x, __m128 ceilLanes)
+	{
+		__m128 t = truncate(x);
+		const __m128 one = _mm_set1_ps(1.f);
+		__m128 down = _mm_and_ps(_mm_andnot_ps(ceilLanes, _mm_cmpgt_ps(t, x)), one);
+		__m128 up = _mm_and_ps(_mm_and_ps(ceilLanes, _mm_cmplt_ps(t, x)), one);
+		return withSign(_mm_add_ps(_mm_sub_ps(t, down), up), x);
+	}
+
+	inline __m128 snapVector(__m128 x, DSnapMode mode, __m128 ceilLanes, __m128 scale, bool scaled)
+	{
+		if (scaled) x = _mm_mul_ps(x, scale);
+		__m128 r;
+		switch (mode)
+		{
+		case DSnapHalfPixel: r = halfPixel(x); break;
+		case DSnapNearest: r = nearest(x); break;
+		default: r = floorCeil(x, ceilLanes); break;
+		}
+		return scaled ? _mm_div_ps(r, scale) : r;
+	}
+#endif
+
+	// lanes repeat every four floats; outward rounding floors lanes 0-1 and, for rects, ceils 2-3
+	void snapFloats(float*values, size_t count, DSnapMode mode, float scale, bool rects)
+	{
+		Rounding low = mode == DSnapHalfPixel ? RoundHalfPixel : (mode == DSnapNearest ? RoundNearest : RoundFloor);
+		Rounding high = (mode == DSnapOutward && rects) ? RoundCeil : low;
+
+		size_t i = 0;
+#ifdef DKGEOMETRY_SSE2
+		__m128 ceilLanes = rects ? _mm_castsi128_ps(_mm_set_epi32(-1, -1, 0, 0)) : _mm_setzero_ps();
+		__m128 scaleVector = _mm_set1_ps(scale);
+		bool scaled = scale != 1.f;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(values + i);
+			_mm_storeu_ps(values + i, snapVector(x, mode, ceilLanes, scaleVector, scaled));
+		}
+#endif
+		for (; i < count; i++)
+		{
+			values[i] = snapScalar(values[i], (i & 2) ? high : low, scale);
+		}
+	}
+}
+
+
+void DKGeometry::SnapRects(DRect * rects, size_t count, DSnapMode mode, float scale)
+{
+	snapFloats(&rects->left, count * 4, mode, scale, true);
+}
+
+void DKGeometry::SnapRects(DRectArray & rects, DSnapMode mode, float scale)
+{
+	SnapRects(rects.data(), rects.size(), mode, scale);
+}
+
+void DKGeometry::SnapPoints(DPoint * points, size_t count, DSnapMode mode, float scale)
+{
+	snapFloats(&points->x, count * 2, mode, scale, false);
+}
+
+void DKGeometry::SnapPoints(DPointArray & points, DSnapMode mode, float scale)
+{
+	SnapPoints(points.data(), points.size(), mode, scale);
+}
@@ -0,0 +1,49 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKGeometry.h"
+
+namespace DKGeometry
+{
+	enum DSnapMode
+	{
+		DSnapHalfPixel,		// fixDim: to the nearest pixel center
+		DSnapNearest,		// to the nearest pixel edge, ties to even
+		DSnapOutward		// rects grow to whole pixels, points floor to their pixel
+	};
+
+	/// <summary>
+	/// Snaps every coordinate of the array to the pixel grid.
+	/// scale is device pixels per unit; coordinates are snapped in device
+	/// space and mapped back, so 2.f snaps to half units on a HiDPI display.
+	/// DSnapHalfPixel with scale 1 gives exactly DRect::fix and DPoint::fix.</summary>
+	void SnapRects(DRect*rects, size_t count, DSnapMode mode = DSnapHalfPixel, float scale = 1.f);
+	void SnapRects(DRectArray&rects, DSnapMode mode = DSnapHalfPixel, float scale = 1.f);
+
+	void SnapPoints(DPoint*points, size_t count, DSnapMode mode = DSnapHalfPixel, float scale = 1.f);
+	void SnapPoints(DPointArray&points, DSnapMode mode = DSnapHalfPixel, float scale = 1.f);
+
+}
@@ -0,0 +1,319 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKSnapshot.h"
+
+#include <string.h>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace DKGeometry;
+
+static_assert(sizeof(IDRect) == 24, "snapshot AoS layout expects 24 byte IDRects");
+static_assert(sizeof(DRectIndexNode) == 24, "snapshot index pages expect 24 byte nodes");
+
+static const char snapshotMagic[8] = { 'D', 'K', 'R', 'E', 'C', 'T', 'S', 0 };
+
+static inline uint64_t alignOffset(uint64_t offset)
+{
+	return (offset + DRectSnapshotAlignment - 1) & ~(uint64_t)(DRectSnapshotAlignment - 1);
+}
+
+static void writeSection(std::ofstream&file, uint64_t offset, const void*data, size_t bytes)
+{
+	static const char padding[DRectSnapshotAlignment] = {};
+	uint64_t position = (uint64_t)file.tellp();
+	if (offset > position) file.write(padding, (std::streamsize)(offset - position));
+	if (bytes) file.write((const char*)data, (std::streamsize)bytes);
+}
+
+static bool writeSnapshot(const std::string&path, const IDRArray&items, const DRectIndexNode*nodes,
+	size_t nodeCount, size_t leafCount, DSnapshotLayout layout)
+{
+	DRectSnapshotHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+	header.version = DRectSnapshotVersion;
+	header.layout = layout;
+	header.itemCount = items.size();
+	header.nodeCount = nodeCount;
+	header.leafCount = leafCount;
+
+	DRect bounds;
+	if (!items.empty())
+	{
+		bounds = items.front();
+		for (const auto&eachItem : items) bounds.CombineWith(eachItem);
+	}
+	header.bounds[0] = bounds.left;
+	header.bounds[1] = bounds.top;
+	header.bounds[2] = bounds.right;
+	header.bounds[3] = bounds.bottom;
+
+	uint64_t count = items.size();
+	uint64_t offset = alignOffset(sizeof(header));
+	header.itemsOffset = offset;
+	if (layout == DSnapshotAoS) {
+		offset = alignOffset(offset + count * sizeof(IDRect));
+	}
+	else {
+		offset = alignOffset(offset + count * sizeof(float));
+		header.topOffset = offset;
+		offset = alignOffset(offset + count * sizeof(float));
+		header.rightOffset = offset;
+		offset = alignOffset(offset + count * sizeof(float));
+		header.bottomOffset = offset;
+		offset = alignOffset(offset + count * sizeof(float));
+		header.idOffset = offset;
+		offset = alignOffset(offset + count * sizeof(uint64_t));
+	}
+	if (nodeCount) {
+		header.nodeOffset = offset;
+		offset += nodeCount * sizeof(DRectIndexNode);
+	}
+	header.fileSize = offset;
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) return false;
+
+	writeSection(file, 0, &header, sizeof(header));
+	if (layout == DSnapshotAoS) {
+		writeSection(file, header.itemsOffset, items.data(), items.size() * sizeof(IDRect));
+	}
+	else {
+		// one column at a time through a reused buffer
+		std::vector<float> column(items.size());
+		const uint64_t offsets[4] = { header.itemsOffset, header.topOffset, header.rightOffset, header.bottomOffset };
+		for (int side = 0; side < 4; side++)
+		{
+			for (size_t i = 0; i < items.size(); i++)
+			{
+				const IDRect&item = items[i];
+				column[i] = (side == 0) ? item.left : (side == 1) ? item.top : (side == 2) ? item.right : item.bottom;
+			}
+			writeSection(file, offsets[side], column.data(), column.size() * sizeof(float));
+		}
+
+		std::vector<uint64_t> idColumn(items.size());
+		for (size_t i = 0; i < items.size(); i++) idColumn[i] = items[i].id;
+		writeSection(file, header.idOffset, idColumn.data(), idColumn.size() * sizeof(uint64_t));
+	}
+	if (nodeCount) {
+		writeSection(file, header.nodeOffset, nodes, nodeCount * sizeof(DRectIndexNode));
+	}
+
+	file.flush();
+	return file.good();
+}
+
+bool DKGeometry::WriteRectSnapshot(const std::string & path, const IDRArray & rects, DSnapshotLayout layout, bool includeIndex)
+{
+	if (includeIndex)
+	{
+		DRectIndex index(rects);
+		return WriteRectSnapshot(path, index, layout);
+	}
+	return writeSnapshot(path, rects, nullptr, 0, 0, layout);
+}
+
+bool DKGeometry::WriteRectSnapshot(const std::string & path, const DRectIndex & index, DSnapshotLayout layout)
+{
+	const auto&nodes = index.getNodes();
+	return writeSnapshot(path, index.getItems(), nodes.data(), nodes.size(), index.leafNodeCount(), layout);
+}
+
+
+bool DKGeometry::DRectSnapshot::Open(const std::string & path)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(DRectSnapshotHeader))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	const void*view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+	if (!view)
+	{
+		if (mapping) CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	fileHandle = file;
+	mappingHandle = mapping;
+	mappedSize = (size_t)fileSize.QuadPart;
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) return false;
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size < (off_t)sizeof(DRectSnapshotHeader))
+	{
+		close(file);
+		return false;
+	}
+
+	void*view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, file, 0);
+	close(file);
+	if (view == MAP_FAILED) return false;
+
+	mappedSize = (size_t)info.st_size;
+#endif
+
+	base = (const char*)view;
+	const DRectSnapshotHeader*candidate = (const DRectSnapshotHeader*)base;
+
+	// reject anything whose sections would read past the mapping
+	uint64_t count = candidate->itemCount;
+	bool valid = memcmp(candidate->magic, snapshotMagic, sizeof(snapshotMagic)) == 0 &&
+		candidate->version == DRectSnapshotVersion &&
+		candidate->fileSize <= mappedSize &&
+		count <= mappedSize;
+	if (valid)
+	{
+		auto fits = [this](uint64_t offset, uint64_t bytes) {
+			return offset % DRectSnapshotAlignment == 0 && offset <= mappedSize && bytes <= mappedSize - offset;
+		};
+		if (candidate->layout == DSnapshotAoS) {
+			valid = fits(candidate->itemsOffset, count * sizeof(IDRect));
+		}
+		else if (candidate->layout == DSnapshotSoA) {
+			valid = fits(candidate->itemsOffset, count * sizeof(float)) &&
+				fits(candidate->topOffset, count * sizeof(float)) &&
+				fits(candidate->rightOffset, count * sizeof(float)) &&
+				fits(candidate->bottomOffset, count * sizeof(float)) &&
+				fits(candidate->idOffset, count * sizeof(uint64_t));
+		}
+		else {
+			valid = false;
+		}
+
+		if (valid && candidate->nodeCount)
+		{
+			valid = candidate->nodeCount <= mappedSize &&
+				candidate->leafCount <= candidate->nodeCount &&
+				fits(candidate->nodeOffset, candidate->nodeCount * sizeof(DRectIndexNode));
+
+			// nodes must be laid out exactly as DRectIndex::Build packs them, each
+			// level partitioning the one below; that bounds the depth the fixed
+			// traversal stacks rely on and keeps a corrupt file inside the mapping
+			const DRectIndexNode*nodes = (const DRectIndexNode*)(base + candidate->nodeOffset);
+			const uint64_t nodeSize = DRectIndex::NodeSize;
+			uint64_t childStart = 0;
+			uint64_t childEnd = count;
+			uint64_t levelStart = 0;
+			uint64_t levelEnd = (count + nodeSize - 1) / nodeSize;
+			valid = valid && count != 0 && candidate->leafCount == levelEnd;
+			while (valid)
+			{
+				valid = levelEnd <= candidate->nodeCount;
+				for (uint64_t i = levelStart; valid && i < levelEnd; i++)
+				{
+					uint64_t first = childStart + (i - levelStart) * nodeSize;
+					valid = nodes[i].first == first && nodes[i].count == (std::min)(nodeSize, childEnd - first);
+				}
+				if (!valid || levelEnd - levelStart == 1) break;
+
+				childStart = levelStart;
+				childEnd = levelEnd;
+				levelStart = levelEnd;
+				levelEnd += (childEnd - childStart + nodeSize - 1) / nodeSize;
+			}
+			valid = valid && levelEnd == candidate->nodeCount;
+		}
+	}
+
+	header = candidate;
+	if (!valid) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void DKGeometry::DRectSnapshot::Close()
+{
+	if (base)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(base);
+#else
+		munmap((void*)base, mappedSize);
+#endif
+	}
+#ifdef _WIN32
+	if (mappingHandle) CloseHandle((HANDLE)mappingHandle);
+	if (fileHandle) CloseHandle((HANDLE)fileHandle);
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+#endif
+	base = nullptr;
+	header = nullptr;
+	mappedSize = 0;
+}
+
+DArrayView<IDRect> DKGeometry::DRectSnapshot::rects() const
+{
+	DArrayView<IDRect> result;
+	if (header && layout() == DSnapshotAoS)
+	{
+		result.items = (const IDRect*)(base + header->itemsOffset);
+		result.count = (size_t)header->itemCount;
+	}
+	return result;
+}
+
+DRectIndexView DKGeometry::DRectSnapshot::index() const
+{
+	DRectIndexView result;
+	if (!hasIndex()) return result;
+
+	result.nodes = (const DRectIndexNode*)(base + header->nodeOffset);
+	result.nodeCount = (size_t)header->nodeCount;
+	result.leafCount = (size_t)header->leafCount;
+	result.itemCount = (size_t)header->itemCount;
+	if (layout() == DSnapshotAoS) result.items = (const IDRect*)(base + header->itemsOffset);
+	return result;
+}
@@ -0,0 +1,154 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKRectIndex.h"
+
+#include <string>
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Binary rect snapshot, version 1. Little-endian, every section starts on
+	/// a 64 byte boundary so it can be used in place from a mapped file.
+	///
+	///   header      DRectSnapshotHeader
+	///   items       AoS: IDRect[itemCount]
+	///               SoA: float left[], top[], right[], bottom[], uint64_t id[]
+	///   index       optional DRectIndexNode[nodeCount], leaves first; when
+	///               present the items are stored in the index's leaf order
+	/// </summary>
+	enum DSnapshotLayout : uint32_t
+	{
+		DSnapshotAoS = 0,
+		DSnapshotSoA = 1
+	};
+
+	static const uint32_t DRectSnapshotVersion = 1;
+	static const uint32_t DRectSnapshotAlignment = 64;
+
+	struct DRectSnapshotHeader
+	{
+		char magic[8];			// "DKRECTS"
+		uint32_t version;
+		uint32_t layout;		// DSnapshotLayout
+		uint64_t itemCount;
+		float bounds[4];		// left, top, right, bottom of all items
+		uint64_t itemsOffset;	// AoS items, or the left column
+		uint64_t topOffset;		// SoA columns, zero for AoS
+		uint64_t rightOffset;
+		uint64_t bottomOffset;
+		uint64_t idOffset;
+		uint64_t nodeOffset;	// zero when no index is stored
+		uint64_t nodeCount;
+		uint64_t leafCount;
+		uint64_t fileSize;
+	};
+
+	template <class T>
+	struct DArrayView
+	{
+		const T* items = nullptr;
+		size_t count = 0;
+
+		inline const T* data() const { return items; }
+		inline size_t size() const { return count; }
+		inline bool empty() const { return count == 0; }
+		inline const T* begin() const { return items; }
+		inline const T* end() const { return items + count; }
+		inline const T& operator[](size_t index) const { return items[index]; }
+	};
+
+	/// <summary>
+	/// Writes rects as a snapshot. With includeIndex a DRectIndex is built
+	/// and its node pages are stored, with the items in leaf order.</summary>
+	/// <returns>
+	/// false if the file could not be written
+	/// </returns>
+	bool WriteRectSnapshot(const std::string&path, const IDRArray&rects, DSnapshotLayout layout = DSnapshotAoS, bool includeIndex = true);
+
+	/// <summary>
+	/// Writes an already built index and its items.</summary>
+	bool WriteRectSnapshot(const std::string&path, const DRectIndex&index, DSnapshotLayout layout = DSnapshotAoS);
+
+	/// <summary>
+	/// Read-only memory-mapped snapshot. Every accessor points straight into
+	/// the mapping; nothing is parsed or copied, so pages fault in on first use.</summary>
+	class DRectSnapshot
+	{
+	public:
+		DRectSnapshot() {}
+		~DRectSnapshot() { Close(); }
+
+		DRectSnapshot(const DRectSnapshot&) = delete;
+		DRectSnapshot& operator=(const DRectSnapshot&) = delete;
+
+		// validates the header and section table before exposing anything
+		bool Open(const std::string&path);
+		void Close();
+
+		inline bool isOpen() const { return header != nullptr; }
+		inline DSnapshotLayout layout() const { return header ? (DSnapshotLayout)header->layout : DSnapshotAoS; }
+		inline size_t size() const { return header ? (size_t)header->itemCount : 0; }
+		inline DRect bounds() const { return header ? DRect(header->bounds[0], header->bounds[1], header->bounds[2], header->bounds[3]) : DRect(); }
+		inline bool hasIndex() const { return header && header->nodeCount != 0; }
+
+		// AoS only
+		DArrayView<IDRect> rects() const;
+
+		// SoA only
+		DArrayView<float> lefts() const { return column<float>(header->itemsOffset); }
+		DArrayView<float> tops() const { return column<float>(header->topOffset); }
+		DArrayView<float> rights() const { return column<float>(header->rightOffset); }
+		DArrayView<float> bottoms() const { return column<float>(header->bottomOffset); }
+		DArrayView<uint64_t> ids() const { return column<uint64_t>(header->idOffset); }
+
+		/// <summary>
+		/// The stored index. For SoA snapshots the view has no items, so
+		/// Visit, Search and ray casts find nothing; use VisitLeaves and the
+		/// columns instead.</summary>
+		DRectIndexView index() const;
+
+	private:
+		template <class T>
+		DArrayView<T> column(uint64_t offset) const {
+			DArrayView<T> result;
+			if (header && layout() == DSnapshotSoA) {
+				result.items = (const T*)(base + offset);
+				result.count = (size_t)header->itemCount;
+			}
+			return result;
+		}
+
+		const char* base = nullptr;
+		const DRectSnapshotHeader* header = nullptr;
+		size_t mappedSize = 0;
+#ifdef _WIN32
+		void* fileHandle = nullptr;
+		void* mappingHandle = nullptr;
+#endif
+	};
+
+}
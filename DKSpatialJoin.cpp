@@ -0,0 +1,237 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKSpatialJoin.h"
+
+#include <math.h>
+
+using namespace DKGeometry;
+
+
+namespace
+{
+	struct JoinGrid
+	{
+		float x0, y0;
+		float cellWidth, cellHeight;
+		int columns, rows;
+
+		// clamped before the cast, so NaN and infinite inputs land in cell 0
+		// or the last cell instead of converting out of range
+		inline int column(float x) const { return cell((x - x0) / cellWidth, columns); }
+		inline int row(float y) const { return cell((y - y0) / cellHeight, rows); }
+
+		static inline int cell(float position, int count) {
+			if (!(position > 0)) return 0;
+			return position < count ? (std::min)((int)position, count - 1) : count - 1;
+		}
+	};
+
+	// rects of one side bucketed by cell, compressed row storage
+	struct CellLists
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> items;
+	};
+
+	void normalizeAll(const IDRArray&source, std::vector<DRect>&rects)
+	{
+		rects.resize(source.size());
+		for (size_t i = 0; i < source.size(); i++)
+		{
+			rects[i] = source[i];
+			rects[i].Normalize();
+		}
+	}
+
+	void bucket(const std::vector<DRect>&rects, const JoinGrid&grid, CellLists&cells)
+	{
+		size_t cellCount = (size_t)grid.columns * grid.rows;
+		cells.offsets.assign(cellCount + 1, 0);
+
+		for (const auto&eachRect : rects)
+		{
+			int c0 = grid.column(eachRect.left), c1 = grid.column(eachRect.right);
+			int r0 = grid.row(eachRect.top), r1 = grid.row(eachRect.bottom);
+			for (int r = r0; r <= r1; r++)
+				for (int c = c0; c <= c1; c++)
+					cells.offsets[(size_t)r * grid.columns + c + 1]++;
+		}
+		for (size_t i = 0; i < cellCount; i++) cells.offsets[i + 1] += cells.offsets[i];
+
+		std::vector<uint32_t> fill(cells.offsets.begin(), cells.offsets.end() - 1);
+		cells.items.resize(cells.offsets.back());
+		for (uint32_t i = 0; i < (uint32_t)rects.size(); i++)
+		{
+			const DRect&rect = rects[i];
+			int c0 = grid.column(rect.left), c1 = grid.column(rect.right);
+			int r0 = grid.row(rect.top), r1 = grid.row(rect.bottom);
+			for (int r = r0; r <= r1; r++)
+				for (int c = c0; c <= c1; c++)
+					cells.items[fill[(size_t)r * grid.columns + c]++] = i;
+		}
+	}
+
+	JoinGrid makeGrid(const std::vector<DRect>&left, const std::vector<DRect>&right)
+	{
+		DRect bounds = GetCombinedRect(left.data(), left.size());
+		bounds.CombineWith(GetCombinedRect(right.data(), right.size()));
+
+		double width = (std::max)(bounds.Width(), FLT_EPSILON);
+		double height = (std::max)(bounds.Height(), FLT_EPSILON);
+		double cells = (double)(left.size() + right.size()) / DJoinCellTarget;
+		double columns = sqrt(cells * width / height);
+		double rows = columns > 0 ? cells / columns : 1;
+
+		const double MaxCells = 4096;
+		JoinGrid grid;
+		grid.columns = (int)(std::min)(MaxCells, (std::max)(1.0, ceil(columns)));
+		grid.rows = (int)(std::min)(MaxCells, (std::max)(1.0, ceil(rows)));
+		grid.x0 = bounds.left;
+		grid.y0 = bounds.top;
+		grid.cellWidth = (float)(width / grid.columns);
+		grid.cellHeight = (float)(height / grid.rows);
+		return grid;
+	}
+
+	// plane sweep along x over the two lists of one cell; emit(l, r) once per
+	// pair whose reference point falls into this cell
+	template <class Emit>
+	void joinCell(const std::vector<DRect>&left, const std::vector<DRect>&right,
+		std::vector<uint32_t>&a, std::vector<uint32_t>&b,
+		const JoinGrid&grid, int column, int row, Emit emit)
+	{
+		auto byLeft = [](const std::vector<DRect>&rects) {
+			return [&rects](uint32_t x, uint32_t y) {
+				return rects[x].left < rects[y].left || (rects[x].left == rects[y].left && x < y);
+			};
+		};
+		std::sort(a.begin(), a.end(), byLeft(left));
+		std::sort(b.begin(), b.end(), byLeft(right));
+
+		auto report = [&](uint32_t l, uint32_t r) {
+			const DRect&lr = left[l];
+			const DRect&rr = right[r];
+			if (lr.bottom < rr.top || rr.bottom < lr.top) return;
+			float x = (std::max)(lr.left, rr.left);
+			float y = (std::max)(lr.top, rr.top);
+			if (grid.column(x) != column || grid.row(y) != row) return;
+			emit(l, r);
+		};
+
+		size_t i = 0, j = 0;
+		while (i < a.size() && j < b.size())
+		{
+			if (left[a[i]].left <= right[b[j]].left)
+			{
+				const DRect&lr = left[a[i]];
+				for (size_t k = j; k < b.size() && right[b[k]].left <= lr.right; k++)
+					report(a[i], b[k]);
+				i++;
+			}
+			else
+			{
+				const DRect&rr = right[b[j]];
+				for (size_t k = i; k < a.size() && left[a[k]].left <= rr.right; k++)
+					report(a[k], b[j]);
+				j++;
+			}
+		}
+	}
+
+	// runs the join and hands every pair to make, collecting per chunk of cells
+	template <class Result, class Make>
+	void join(const IDRArray&leftSource, const IDRArray&rightSource, std::vector<Result>&results,
+		DExecutor&executor, Make make)
+	{
+		if (leftSource.empty() || rightSource.empty()) return;
+
+		std::vector<DRect> left, right;
+		normalizeAll(leftSource, left);
+		normalizeAll(rightSource, right);
+
+		JoinGrid grid = makeGrid(left, right);
+		CellLists leftCells, rightCells;
+		bucket(left, grid, leftCells);
+		bucket(right, grid, rightCells);
+
+		size_t cellCount = (size_t)grid.columns * grid.rows;
+		const size_t CellGrain = 16;
+		std::vector<std::vector<Result>> partials((cellCount + CellGrain - 1) / CellGrain);
+
+		executor.parallelFor(cellCount, CellGrain, [&](size_t begin, size_t end) {
+			std::vector<Result>&out = partials[begin / CellGrain];
+			std::vector<uint32_t> a, b;
+			for (size_t cell = begin; cell < end; cell++)
+			{
+				if (leftCells.offsets[cell] == leftCells.offsets[cell + 1] ||
+					rightCells.offsets[cell] == rightCells.offsets[cell + 1])
+					continue;
+
+				a.assign(leftCells.items.begin() + leftCells.offsets[cell], leftCells.items.begin() + leftCells.offsets[cell + 1]);
+				b.assign(rightCells.items.begin() + rightCells.offsets[cell], rightCells.items.begin() + rightCells.offsets[cell + 1]);
+				joinCell(left, right, a, b, grid, (int)(cell % grid.columns), (int)(cell / grid.columns),
+					[&](uint32_t l, uint32_t r) { out.push_back(make(l, r, left[l], right[r])); });
+			}
+		});
+
+		size_t total = results.size();
+		for (const auto&eachPartial : partials) total += eachPartial.size();
+		results.reserve(total);
+		for (const auto&eachPartial : partials)
+			results.insert(results.end(), eachPartial.begin(), eachPartial.end());
+	}
+}
+
+
+void DKGeometry::SpatialJoin(const IDRArray & left, const IDRArray & right, DJoinPairArray & results, DExecutor & executor)
+{
+	join(left, right, results, executor, [&](uint32_t l, uint32_t r, const DRect&, const DRect&) {
+		return DJoinPair{ left[l].id, right[r].id };
+	});
+}
+
+void DKGeometry::SpatialJoin(const IDRArray & left, const IDRArray & right, DJoinHitArray & results, int options, DExecutor & executor)
+{
+	join(left, right, results, executor, [&](uint32_t l, uint32_t r, const DRect&lr, const DRect&rr) {
+		DJoinHit hit;
+		hit.leftId = left[l].id;
+		hit.rightId = right[r].id;
+		hit.comparison.flat = 0;
+		if (options & DJoinIntersection)
+		{
+			hit.intersection = DRect((std::max)(lr.left, rr.left), (std::max)(lr.top, rr.top),
+				(std::min)(lr.right, rr.right), (std::min)(lr.bottom, rr.bottom));
+		}
+		if (options & DJoinComparison)
+		{
+			hit.comparison = left[l].compareToRect(right[r], (options & DJoinSharedEdges) != 0);
+		}
+		return hit;
+	});
+}
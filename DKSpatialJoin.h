@@ -0,0 +1,75 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKThreadPool.h"
+
+namespace DKGeometry
+{
+	enum DJoinOptions
+	{
+		DJoinIds			= 0,
+		DJoinIntersection	= 1,	// fill DJoinHit::intersection
+		DJoinComparison		= 2,	// fill DJoinHit::comparison from compareToRect
+		DJoinSharedEdges	= 4		// pass getSharedEdges to compareToRect
+	};
+
+	struct DJoinPair
+	{
+		uint64_t leftId;
+		uint64_t rightId;
+	};
+
+	struct DJoinHit
+	{
+		uint64_t leftId;
+		uint64_t rightId;
+		DRect intersection;
+		RectComparision comparison;
+	};
+
+	typedef std::vector<DJoinPair> DJoinPairArray;
+	typedef std::vector<DJoinHit> DJoinHitArray;
+
+	/// <summary>
+	/// Partition based spatial merge join: every pair (l, r) with
+	/// l.Intersects(r), touching edges included.
+	///
+	/// Both inputs are bucketed into a uniform grid over their combined bounds,
+	/// a rect going into every cell it covers, and the cells are joined in
+	/// parallel with a plane sweep. A pair found in several cells is only
+	/// reported by the cell holding the top-left corner of its intersection, so
+	/// there are no duplicates. Output is grouped by cell in row-major order and
+	/// is identical for any executor.</summary>
+	void SpatialJoin(const IDRArray&left, const IDRArray&right, DJoinPairArray&results,
+		DExecutor&executor = DefaultExecutor());
+
+	void SpatialJoin(const IDRArray&left, const IDRArray&right, DJoinHitArray&results,
+		int options = DJoinIntersection, DExecutor&executor = DefaultExecutor());
+
+	// rough number of rects per grid cell the partitioning aims for
+	const size_t DJoinCellTarget = 64;
+
+}
@@ -0,0 +1,203 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKSpatialSort.h"
+
+using namespace DKGeometry;
+
+
+uint32_t DKGeometry::MortonKey(uint16_t x, uint16_t y)
+{
+	// spread the 16 bits of each axis to the even positions
+	auto spread = [](uint32_t v) {
+		v = (v | (v << 8)) & 0x00FF00FF;
+		v = (v | (v << 4)) & 0x0F0F0F0F;
+		v = (v | (v << 2)) & 0x33333333;
+		v = (v | (v << 1)) & 0x55555555;
+		return v;
+	};
+	return spread(x) | (spread(y) << 1);
+}
+
+uint32_t DKGeometry::HilbertKey(uint16_t x, uint16_t y)
+{
+	uint32_t rx, ry, key = 0;
+	uint32_t px = x, py = y;
+	for (uint32_t s = 1u << 15; s > 0; s >>= 1)
+	{
+		rx = (px & s) ? 1 : 0;
+		ry = (py & s) ? 1 : 0;
+		key += s * s * ((3 * rx) ^ ry);
+
+		// rotate the quadrant so the curve stays continuous
+		if (ry == 0)
+		{
+			if (rx == 1)
+			{
+				px = s - 1 - (px & (s - 1)) + (px & ~(s - 1));
+				py = s - 1 - (py & (s - 1)) + (py & ~(s - 1));
+			}
+			uint32_t t = px;
+			px = py;
+			py = t;
+		}
+	}
+	return key;
+}
+
+namespace
+{
+	const size_t SortGrain = 65536;
+	const int RadixBits = 8;
+	const size_t Buckets = 1 << RadixBits;
+
+	// entries hold the key in the high half and the input position in the low half;
+	// sorting by the high half only leaves equal keys in position order
+	void radixSort(std::vector<uint64_t>&entries, DExecutor&executor)
+	{
+		size_t count = entries.size();
+		size_t chunks = (count + SortGrain - 1) / SortGrain;
+		std::vector<uint64_t> scratch(count);
+		std::vector<uint32_t> counts(chunks * Buckets);
+
+		for (int shift = 32; shift < 64; shift += RadixBits)
+		{
+			std::fill(counts.begin(), counts.end(), 0);
+			executor.parallelFor(count, SortGrain, [&](size_t begin, size_t end) {
+				uint32_t*chunkCounts = counts.data() + (begin / SortGrain) * Buckets;
+				for (size_t i = begin; i < end; i++) chunkCounts[(entries[i] >> shift) & (Buckets - 1)]++;
+			});
+
+			// a pass where every key shares the digit would only copy
+			bool trivial = false;
+			for (size_t bucket = 0; bucket < Buckets && !trivial; bucket++)
+			{
+				uint32_t total = 0;
+				for (size_t chunk = 0; chunk < chunks; chunk++) total += counts[chunk * Buckets + bucket];
+				trivial = total == count;
+			}
+			if (trivial) continue;
+
+			uint32_t offset = 0;
+			for (size_t bucket = 0; bucket < Buckets; bucket++)
+			{
+				for (size_t chunk = 0; chunk < chunks; chunk++)
+				{
+					uint32_t&slot = counts[chunk * Buckets + bucket];
+					uint32_t bucketCount = slot;
+					slot = offset;
+					offset += bucketCount;
+				}
+			}
+
+			executor.parallelFor(count, SortGrain, [&](size_t begin, size_t end) {
+				uint32_t*cursor = counts.data() + (begin / SortGrain) * Buckets;
+				for (size_t i = begin; i < end; i++)
+				{
+					scratch[cursor[(entries[i] >> shift) & (Buckets - 1)]++] = entries[i];
+				}
+			});
+			entries.swap(scratch);
+		}
+	}
+
+	// rectOf(i) reads the input, so IDRArrays are ordered without a DRect copy
+	template <class RectFunc>
+	void curveOrder(size_t count, RectFunc rectOf, DCurve curve, std::vector<uint32_t>&order, DExecutor&executor)
+	{
+		order.resize(count);
+		if (count == 0) return;
+
+		DRect centers = ParallelReduce(executor, count, SortGrain,
+			DRect(DKInfinity, DKInfinity, DKNegInfinity, DKNegInfinity),
+			[&rectOf](size_t begin, size_t end) {
+				DRect bounds(DKInfinity, DKInfinity, DKNegInfinity, DKNegInfinity);
+				for (size_t i = begin; i < end; i++)
+				{
+					DPoint center = rectOf(i).center();
+					bounds.CombineWith(DRect(center, center));
+				}
+				return bounds;
+			},
+			[](DRect combined, const DRect&partial) {
+				combined.CombineWith(partial);
+				return combined;
+			});
+
+		double scaleX = centers.Width() > 0 ? 65535.0 / centers.Width() : 0;
+		double scaleY = centers.Height() > 0 ? 65535.0 / centers.Height() : 0;
+
+		std::vector<uint64_t> entries(count);
+		executor.parallelFor(count, SortGrain, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++)
+			{
+				DPoint center = rectOf(i).center();
+				double fx = (center.x - centers.left) * scaleX;
+				double fy = (center.y - centers.top) * scaleY;
+				// NaN centers land on cell 0
+				uint16_t x = fx > 0 ? (uint16_t)(std::min)(fx, 65535.0) : 0;
+				uint16_t y = fy > 0 ? (uint16_t)(std::min)(fy, 65535.0) : 0;
+				uint32_t key = curve == DCurveHilbert ? HilbertKey(x, y) : MortonKey(x, y);
+				entries[i] = ((uint64_t)key << 32) | (uint32_t)i;
+			}
+		});
+
+		radixSort(entries, executor);
+		for (size_t i = 0; i < count; i++) order[i] = (uint32_t)entries[i];
+	}
+
+	template <class RectType>
+	void sortArray(std::vector<RectType>&rects, DCurve curve, DExecutor&executor)
+	{
+		if (rects.size() < 2) return;
+
+		std::vector<uint32_t> order;
+		curveOrder(rects.size(), [&rects](size_t i) -> const DRect& { return rects[i]; }, curve, order, executor);
+
+		std::vector<RectType> sorted(rects.size());
+		executor.parallelFor(order.size(), SortGrain, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) sorted[i] = rects[order[i]];
+		});
+		rects.swap(sorted);
+	}
+}
+
+void DKGeometry::SpatialOrder(const DRect * rects, size_t count, DCurve curve, std::vector<uint32_t>& order, DExecutor & executor)
+{
+	curveOrder(count, [rects](size_t i) -> const DRect& { return rects[i]; }, curve, order, executor);
+}
+
+void DKGeometry::SpatialSort(DRectArray & rects, DCurve curve, DExecutor & executor)
+{
+	sortArray(rects, curve, executor);
+}
+
+void DKGeometry::SpatialSort(IDRArray & rects, DCurve curve, DExecutor & executor)
+{
+	sortArray(rects, curve, executor);
+}
@@ -0,0 +1,54 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKThreadPool.h"
+
+namespace DKGeometry
+{
+	enum DCurve
+	{
+		DCurveMorton,	// bit interleave, cheapest to compute
+		DCurveHilbert	// no jumps between neighbouring cells, better locality
+	};
+
+	// curve position of a cell on a 65536 x 65536 grid
+	uint32_t MortonKey(uint16_t x, uint16_t y);
+	uint32_t HilbertKey(uint16_t x, uint16_t y);
+
+	/// <summary>
+	/// Computes the order that sorts rects along a space-filling curve through
+	/// their centers (DRect::center), quantized to 16 bits per axis over the
+	/// centers' bounds. Keys are sorted with a stable parallel LSD radix sort,
+	/// so equal keys keep input order and the result does not depend on the
+	/// executor. order[i] is the input position of the i-th rect.</summary>
+	void SpatialOrder(const DRect*rects, size_t count, DCurve curve, std::vector<uint32_t>&order,
+		DExecutor&executor = DefaultExecutor());
+
+	// reorder in place along the curve
+	void SpatialSort(DRectArray&rects, DCurve curve = DCurveHilbert, DExecutor&executor = DefaultExecutor());
+	void SpatialSort(IDRArray&rects, DCurve curve = DCurveHilbert, DExecutor&executor = DefaultExecutor());
+
+}
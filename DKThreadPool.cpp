@@ -0,0 +1,220 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKThreadPool.h"
+
+using namespace DKGeometry;
+
+// queue owned by the current thread when it is a pool worker
+static thread_local const DThreadPool* workerPool = nullptr;
+static thread_local size_t workerQueue = 0;
+
+static std::atomic<DExecutor*> defaultExecutor{ nullptr };
+
+
+void DKGeometry::DInlineExecutor::parallelFor(size_t count, size_t grain, const RangeFunc & func)
+{
+	if (grain == 0) grain = DefaultGrain;
+	for (size_t begin = 0; begin < count; begin += grain)
+	{
+		func(begin, (std::min)(count, begin + grain));
+	}
+}
+
+
+DKGeometry::DThreadPool::DThreadPool(size_t threadCount)
+{
+	if (threadCount == 0)
+	{
+		size_t hardware = std::thread::hardware_concurrency();
+		threadCount = hardware > 1 ? hardware - 1 : 1;
+	}
+
+	for (size_t i = 0; i <= threadCount; i++)
+	{
+		queues.emplace_back(new WorkQueue());
+	}
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		threads.emplace_back(&DThreadPool::workerLoop, this, i);
+	}
+}
+
+DKGeometry::DThreadPool::~DThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(sleepLock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto&eachThread : threads)
+	{
+		eachThread.join();
+	}
+}
+
+DThreadPool & DKGeometry::DThreadPool::Default()
+{
+	static DThreadPool pool;
+	return pool;
+}
+
+size_t DKGeometry::DThreadPool::currentQueue() const
+{
+	return workerPool == this ? workerQueue : queues.size() - 1;
+}
+
+void DKGeometry::DThreadPool::push(size_t queue, TaskFunc && task)
+{
+	{
+		std::lock_guard<std::mutex> guard(queues[queue]->lock);
+		queues[queue]->tasks.push_back(std::move(task));
+	}
+	queued.fetch_add(1);
+
+	// a worker counts itself as sleeping before it rechecks queued, so this cannot miss it
+	if (sleeping.load())
+	{
+		{ std::lock_guard<std::mutex> guard(sleepLock); }
+		wake.notify_one();
+	}
+}
+
+bool DKGeometry::DThreadPool::runOne(size_t queue)
+{
+	TaskFunc task;
+	{
+		WorkQueue&own = *queues[queue];
+		std::lock_guard<std::mutex> guard(own.lock);
+		if (!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+		}
+	}
+
+	for (size_t i = 1; !task && i < queues.size(); i++)
+	{
+		WorkQueue&victim = *queues[(queue + i) % queues.size()];
+		std::lock_guard<std::mutex> guard(victim.lock);
+		if (!victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+		}
+	}
+
+	if (!task) return false;
+	queued.fetch_sub(1);
+	task();
+	return true;
+}
+
+void DKGeometry::DThreadPool::runChunks(LoopJob * job, size_t first, size_t last)
+{
+	// keep the lower half and leave the upper half for thieves
+	size_t queue = currentQueue();
+	while (last - first > 1)
+	{
+		size_t middle = first + (last - first) / 2;
+		push(queue, [this, job, middle, last]() { runChunks(job, middle, last); });
+		last = middle;
+	}
+
+	size_t begin = first * job->grain;
+	(*job->func)(begin, (std::min)(job->count, begin + job->grain));
+	job->remaining.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void DKGeometry::DThreadPool::parallelFor(size_t count, size_t grain, const RangeFunc & func)
+{
+	if (count == 0) return;
+	if (grain == 0) grain = DefaultGrain;
+
+	size_t chunks = (count + grain - 1) / grain;
+	if (chunks == 1)
+	{
+		func(0, count);
+		return;
+	}
+
+	LoopJob job;
+	job.func = &func;
+	job.count = count;
+	job.grain = grain;
+	job.remaining.store(chunks);
+	runChunks(&job, 0, chunks);
+
+	// help with whatever is queued until every chunk of this loop is done
+	size_t queue = currentQueue();
+	while (job.remaining.load(std::memory_order_acquire))
+	{
+		if (!runOne(queue)) std::this_thread::yield();
+	}
+}
+
+void DKGeometry::DThreadPool::post(TaskFunc task)
+{
+	push(currentQueue(), std::move(task));
+}
+
+void DKGeometry::DThreadPool::workerLoop(size_t queue)
+{
+	workerPool = this;
+	workerQueue = queue;
+
+	const int SpinRounds = 64;
+	for (;;)
+	{
+		bool ranTask = false;
+		for (int spin = 0; spin < SpinRounds && !ranTask; spin++)
+		{
+			ranTask = runOne(queue);
+			if (!ranTask) std::this_thread::yield();
+		}
+		if (ranTask) continue;
+
+		std::unique_lock<std::mutex> guard(sleepLock);
+		sleeping.fetch_add(1);
+		wake.wait(guard, [this]() { return stopping || queued.load() > 0; });
+		sleeping.fetch_sub(1);
+		if (stopping && queued.load() == 0) return;
+	}
+}
+
+
+DExecutor & DKGeometry::DefaultExecutor()
+{
+	DExecutor*executor = defaultExecutor.load(std::memory_order_acquire);
+	return executor ? *executor : DThreadPool::Default();
+}
+
+void DKGeometry::SetDefaultExecutor(DExecutor * executor)
+{
+	defaultExecutor.store(executor, std::memory_order_release);
+}
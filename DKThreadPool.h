@@ -0,0 +1,157 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKGeometry.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Where batch operations run their work. Implement this to route the
+	/// library's batch calls onto an existing scheduler.
+	///
+	/// parallelFor must call func exactly once for every chunk
+	/// [i * grain, min(count, (i + 1) * grain)) and return when all of them
+	/// have finished. Chunk boundaries depend only on count and grain, never on
+	/// the number of threads, which is what keeps ParallelReduce deterministic.</summary>
+	class DExecutor
+	{
+	public:
+		typedef std::function<void(size_t begin, size_t end)> RangeFunc;
+		typedef std::function<void()> TaskFunc;
+
+		// grain used when a batch call passes 0
+		static const size_t DefaultGrain = 4096;
+
+		virtual ~DExecutor() {}
+
+		virtual void parallelFor(size_t count, size_t grain, const RangeFunc&func) = 0;
+
+		// run task asynchronously, e.g. to resume suspended work
+		virtual void post(TaskFunc task) = 0;
+
+		// threads that may run chunks at once, including the caller
+		virtual size_t concurrency() const = 0;
+	};
+
+	/// <summary>
+	/// Runs everything on the calling thread.</summary>
+	class DInlineExecutor : public DExecutor
+	{
+	public:
+		void parallelFor(size_t count, size_t grain, const RangeFunc&func) override;
+		void post(TaskFunc task) override { task(); }
+		size_t concurrency() const override { return 1; }
+	};
+
+	/// <summary>
+	/// Work-stealing thread pool. Each worker owns a deque; it pushes and pops
+	/// at the back and idle workers steal from the front of the others.
+	/// parallelFor splits its chunk range in halves lazily, so stolen work is
+	/// always the largest remaining piece, and the calling thread helps until
+	/// its loop is done, which also makes nested parallelFor calls safe.</summary>
+	class DThreadPool : public DExecutor
+	{
+	public:
+		// threadCount 0 uses one worker per hardware thread, less the caller
+		explicit DThreadPool(size_t threadCount = 0);
+		~DThreadPool();
+
+		DThreadPool(const DThreadPool&) = delete;
+		DThreadPool& operator=(const DThreadPool&) = delete;
+
+		// process-wide pool, created on first use
+		static DThreadPool& Default();
+
+		void parallelFor(size_t count, size_t grain, const RangeFunc&func) override;
+		void post(TaskFunc task) override;
+		size_t concurrency() const override { return threads.size() + 1; }
+
+		inline size_t threadCount() const { return threads.size(); }
+
+	private:
+		struct alignas(64) WorkQueue
+		{
+			std::mutex lock;
+			std::deque<TaskFunc> tasks;
+		};
+
+		struct LoopJob
+		{
+			const RangeFunc* func;
+			size_t count;
+			size_t grain;
+			std::atomic<size_t> remaining;
+		};
+
+		size_t currentQueue() const;
+		void push(size_t queue, TaskFunc&&task);
+		bool runOne(size_t queue);
+		void runChunks(LoopJob*job, size_t first, size_t last);
+		void workerLoop(size_t queue);
+
+		// one queue per worker plus a shared one for outside threads, last
+		std::vector<std::unique_ptr<WorkQueue>> queues;
+		std::vector<std::thread> threads;
+
+		std::atomic<size_t> queued{ 0 };
+		std::atomic<size_t> sleeping{ 0 };
+		std::mutex sleepLock;
+		std::condition_variable wake;
+		bool stopping = false;
+	};
+
+	/// <summary>
+	/// Executor used by batch calls that are not given one: DThreadPool::Default()
+	/// unless SetDefaultExecutor installed another. Pass nullptr to go back.</summary>
+	DExecutor& DefaultExecutor();
+	void SetDefaultExecutor(DExecutor*executor);
+
+	/// <summary>
+	/// Maps each grain-sized chunk to a partial result and folds the partials
+	/// in chunk order, so the result is the same for any thread count.</summary>
+	template <class T, class MapFunc, class CombineFunc>
+	T ParallelReduce(DExecutor&executor, size_t count, size_t grain, T identity, MapFunc map, CombineFunc combine)
+	{
+		if (grain == 0) grain = DExecutor::DefaultGrain;
+		size_t chunks = (count + grain - 1) / grain;
+		std::vector<T> partials(chunks, identity);
+		executor.parallelFor(count, grain, [&](size_t begin, size_t end) {
+			partials[begin / grain] = map(begin, end);
+		});
+
+		T result = identity;
+		for (const auto&eachPartial : partials) result = combine(result, eachPartial);
+		return result;
+	}
+
+}
@@ -0,0 +1,161 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _MFC_VER
+#include "stdafx.h"
+#endif
+
+#include "DKTileBinning.h"
+
+#include <math.h>
+
+using namespace DKGeometry;
+
+
+namespace
+{
+	// first and last covered tile on each axis; empty when first > last
+	struct TileSpan
+	{
+		int32_t c0, r0, c1, r1;
+	};
+
+	const size_t BinGrain = 16384;
+
+	inline int32_t clampTile(double value, uint32_t limit)
+	{
+		if (value < 0) return 0;
+		if (value >= limit) return (int32_t)limit - 1;
+		return (int32_t)value;
+	}
+
+	inline TileSpan spanOf(const DRect&source, const DTileBins&bins)
+	{
+		DRect rect(source);
+		rect.Normalize();
+
+		TileSpan span = { 0, 0, -1, -1 };
+		const DRect&area = bins.area;
+		if (rect.right < area.left || rect.left > area.right || rect.bottom < area.top || rect.top > area.bottom)
+			return span;
+
+		// a rect with extent that clips to none only touches the area from outside
+		if (rect.left < rect.right && (std::max)(rect.left, area.left) >= (std::min)(rect.right, area.right))
+			return span;
+		if (rect.top < rect.bottom && (std::max)(rect.top, area.top) >= (std::min)(rect.bottom, area.bottom))
+			return span;
+
+		double inverse = 1.0 / bins.tileSize;
+		span.c0 = clampTile(floor((rect.left - area.left) * inverse), bins.columns);
+		span.r0 = clampTile(floor((rect.top - area.top) * inverse), bins.rows);
+		span.c1 = (std::max)(span.c0, clampTile(ceil((rect.right - area.left) * inverse) - 1, bins.columns));
+		span.r1 = (std::max)(span.r0, clampTile(ceil((rect.bottom - area.top) * inverse) - 1, bins.rows));
+		return span;
+	}
+
+	// rectOf(i) and idOf(i) read the input, so no array type needs copying
+	template <class RectFunc, class IdFunc>
+	void binRects(size_t count, RectFunc rectOf, IdFunc idOf, const DRect&area, float tileSize,
+		DTileBins&bins, DExecutor&executor)
+	{
+		bins.area = area;
+		bins.area.Normalize();
+		bins.tileSize = tileSize;
+		bins.columns = tileSize > 0 ? (uint32_t)(std::max)(1.0, ceil((double)bins.area.Width() / tileSize)) : 0;
+		bins.rows = tileSize > 0 ? (uint32_t)(std::max)(1.0, ceil((double)bins.area.Height() / tileSize)) : 0;
+		size_t tiles = bins.tileCount();
+		bins.offsets.assign(tiles + 1, 0);
+		bins.ids.clear();
+		if (tiles == 0 || count == 0) return;
+
+		// pass 1: spans and per chunk tile counts
+		size_t chunks = (count + BinGrain - 1) / BinGrain;
+		std::vector<TileSpan> spans(count);
+		std::vector<uint32_t> counts(chunks * tiles, 0);
+		executor.parallelFor(count, BinGrain, [&](size_t begin, size_t end) {
+			uint32_t*chunkCounts = counts.data() + (begin / BinGrain) * tiles;
+			for (size_t i = begin; i < end; i++)
+			{
+				TileSpan span = spans[i] = spanOf(rectOf(i), bins);
+				if (span.c0 == span.c1 && span.r0 == span.r1)
+				{
+					// fast path, the rect sits inside one tile
+					chunkCounts[bins.tileAt(span.c0, span.r0)]++;
+					continue;
+				}
+				for (int32_t r = span.r0; r <= span.r1; r++)
+					for (int32_t c = span.c0; c <= span.c1; c++)
+						chunkCounts[bins.tileAt(c, r)]++;
+			}
+		});
+
+		// exclusive prefix in tile-major, chunk-minor order keeps input order inside a bin
+		uint32_t total = 0;
+		for (size_t tile = 0; tile < tiles; tile++)
+		{
+			bins.offsets[tile] = total;
+			for (size_t chunk = 0; chunk < chunks; chunk++)
+			{
+				uint32_t&slot = counts[chunk * tiles + tile];
+				uint32_t binCount = slot;
+				slot = total;
+				total += binCount;
+			}
+		}
+		bins.offsets[tiles] = total;
+		bins.ids.resize(total);
+
+		// pass 2: every chunk scatters into the slots it reserved
+		executor.parallelFor(count, BinGrain, [&](size_t begin, size_t end) {
+			uint32_t*cursor = counts.data() + (begin / BinGrain) * tiles;
+			uint64_t*ids = bins.ids.data();
+			for (size_t i = begin; i < end; i++)
+			{
+				const TileSpan&span = spans[i];
+				uint64_t id = idOf(i);
+				if (span.c0 == span.c1 && span.r0 == span.r1)
+				{
+					ids[cursor[bins.tileAt(span.c0, span.r0)]++] = id;
+					continue;
+				}
+				for (int32_t r = span.r0; r <= span.r1; r++)
+					for (int32_t c = span.c0; c <= span.c1; c++)
+						ids[cursor[bins.tileAt(c, r)]++] = id;
+			}
+		});
+	}
+}
+
+
+void DKGeometry::BinRects(const DRectArray & rects, const DRect & area, float tileSize, DTileBins & bins, DExecutor & executor)
+{
+	binRects(rects.size(), [&rects](size_t i) -> const DRect& { return rects[i]; },
+		[](size_t i) { return (uint64_t)i; }, area, tileSize, bins, executor);
+}
+
+void DKGeometry::BinRects(const IDRArray & rects, const DRect & area, float tileSize, DTileBins & bins, DExecutor & executor)
+{
+	binRects(rects.size(), [&rects](size_t i) -> const DRect& { return rects[i]; },
+		[&rects](size_t i) { return rects[i].id; }, area, tileSize, bins, executor);
+}
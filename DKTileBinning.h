@@ -0,0 +1,69 @@
+/*
+MIT License
+
+Copyright (c) 2016 Derek Dean Kowaluk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+#include "DKThreadPool.h"
+
+namespace DKGeometry
+{
+	/// <summary>
+	/// Ids touching each tile of a grid, in compressed row storage: the ids
+	/// of tile t are ids[offsets[t]] .. ids[offsets[t + 1] - 1], in input order.
+	/// Tiles are numbered row-major from the top-left of the binned area.</summary>
+	struct DTileBins
+	{
+		DRect area;
+		float tileSize = 0;
+		uint32_t columns = 0;
+		uint32_t rows = 0;
+		std::vector<uint32_t> offsets;
+		std::vector<uint64_t> ids;
+
+		inline size_t tileCount() const { return (size_t)columns * rows; }
+		inline size_t binSize(size_t tile) const { return offsets[tile + 1] - offsets[tile]; }
+		inline const uint64_t* bin(size_t tile) const { return ids.data() + offsets[tile]; }
+		inline size_t tileAt(uint32_t column, uint32_t row) const { return (size_t)row * columns + column; }
+		inline DRect tileRect(size_t tile) const {
+			float x = area.left + (tile % columns) * tileSize;
+			float y = area.top + (tile / columns) * tileSize;
+			return DRect(x, y, x + tileSize, y + tileSize);
+		}
+	};
+
+	/// <summary>
+	/// Bins rects into square tiles of tileSize covering area.
+	/// A rect lands in every tile whose interior it covers, clipped to area;
+	/// edges are half-open, so a rect ending exactly on a tile boundary does not
+	/// reach the next tile, and a zero-size rect goes to the tile holding it.
+	/// Rects outside area, or touching it only from outside, are skipped.
+	/// Built with two parallel counting-sort passes over fixed chunks, so the
+	/// result does not depend on the executor. DRectArray ids are array
+	/// positions.</summary>
+	void BinRects(const DRectArray&rects, const DRect&area, float tileSize, DTileBins&bins,
+		DExecutor&executor = DefaultExecutor());
+	void BinRects(const IDRArray&rects, const DRect&area, float tileSize, DTileBins&bins,
+		DExecutor&executor = DefaultExecutor());
+
+}